@@ -6,6 +6,7 @@
  */
 #include <ExtADC/ExtADC.h>
 #include <TWI/TWI.h>		// TWI__*
+#include <Timer/Timer.h>	// Timer__*
 
 #define __ADDR_R	0b11010001
 #define __ADDR_W	0b11010000
@@ -14,12 +15,111 @@
 static bool __bStarted	= FALSE;
 static u8 __nCFG		= 0;
 
-static ldbl __dMultiplier[4]		= {
-	1E-3,			/* 12 bits = 1mV      */
-	250E-6,			/* 14 bits = 250uV    */
-	62.5E-6,		/* 16 bits = 62.5uV   */
-	15.625E-6		/* 18 bits = 15.625uV */
-};
+// Flag ob die Konfiguration bereits geschrieben wurde
+static bool __bConfigured	= FALSE;
+
+/*!
+ *	Der ADC läuft im Dauerwandlungsmodus.
+ *	Die Konfiguration wird nur bei einer Änderung geschrieben,
+ *	danach wird jeweils nach Ablauf der Wandlungszeit
+ *	das neueste Messergebnis gelesen.
+ *	Der Datenaustausch läuft über die TWI ISR.
+ */
+#define __STATE_CONFIG		0u
+#define __STATE_WAIT		1u
+#define __STATE_READ		2u
+
+static u8 __nState		= __STATE_WAIT;
+static TWI__transaction_t __transaction;
+
+// Zeitpunkt der Konfiguration bzw. des letzten Lesevorgangs
+static u16 __nLastSample	= 0;
+// Wartezeit bis zum nächsten Lesevorgang in Millisekunden
+static u16 __nWaitTime		= 0;
+
+/*!
+ *	Automatische Gainwahl:
+ *	Ist das letzte Ergebnis kleiner als 3/8 des Messbereichs
+ *	wird der Gain verdoppelt (Ergebnis danach unter 3/4),
+ *	ist es grösser als 7/8 wird der Gain halbiert.
+ *	Der Bereich dazwischen bildet die Hysterese.
+ *	Übersteuerte Ergebnisse werden verworfen.
+ */
+#define __FULL_SCALE		131072l
+#define __GAIN_UP_LIMIT		((__FULL_SCALE * 3) / 8)
+#define __GAIN_DOWN_LIMIT	((__FULL_SCALE * 7) / 8)
+
+static bool __bAutoGain		= FALSE;
+static u8 __nAutoGain		= ExtADCGain1;
+// Gain des letzten gelieferten Messergebnisses
+static u8 __nLastGain		= ExtADCGain1;
+
+// Auf dem I2C Bus übertragene Bytes und gelieferte Messergebnisse
+static u32 __nBusBytes		= 0;
+static u32 __nSamples		= 0;
+
+/*!
+ *	Wandlungszeit in Millisekunden pro Auflösung
+ *	12 Bit (240 SPS), 14 Bit (60 SPS),
+ *	16 Bit (15 SPS), 18 Bit (3.75 SPS)
+ */
+static const u16 __nConversionTime[4] PROGMEM = {5, 20, 70, 270};
+
+/*!
+ *	Um das Konfigurationsregister lesen zu können
+ *	muss erst das Messergebnis gelesen werden.
+ *	Bei 12 bis 16 Bit folgt die Konfiguration nach
+ *	zwei Bytes, bei 18 Bit nach drei Bytes.
+ */
+static u8 __nReadBytes[4];
+
+static INLINE u8 __numReadBytes(u8 nResolution) {
+	return (nResolution == ExtADC18Bit) ? 4 : 3;
+}
+
+static void __submit(const u8 *nWriteBytes, u8 nNumWrite, u8 nNumRead) {
+	__transaction.nAddr			= __ADDR_W;
+	__transaction.nWriteBytes	= nWriteBytes;
+	__transaction.nNumWrite		= nNumWrite;
+	__transaction.nReadBytes	= __nReadBytes;
+	__transaction.nNumRead		= nNumRead;
+	__transaction.callbackFNC	= NULL;
+
+	// Adressbyte pro Übertragungsrichtung und Datenbytes zählen
+	__nBusBytes += (nNumWrite > 0) + (nNumRead > 0) + nNumWrite + nNumRead;
+
+	// Ausser dem externen ADC benutzt niemand den I2C Bus
+	if (!TWI__submit(&__transaction)) {
+		PANIC("I2C Warteschlange voll");
+	}
+}
+
+static void __configure(u8 nCFG) {
+	// Konfiguration lokal speichern
+	__nCFG = nCFG;
+
+	// Konfiguration schreiben, Wandlung startet neu
+	__submit(&__nCFG, 1, 0);
+
+	__nLastSample	= Timer__getTicks();
+	__nWaitTime		= pgm_read_word(&__nConversionTime[(nCFG & 0b00001100) >> 2u]);
+	__nState		= __STATE_CONFIG;
+	__bConfigured	= TRUE;
+}
+
+/*!
+ *	Alle Auflösungen werden auf das LSB der
+ *	18 Bit Auflösung (15.625uV) normiert.
+ *	12 bits = 1mV      = 64 LSB
+ *	14 bits = 250uV    = 16 LSB
+ *	16 bits = 62.5uV   =  4 LSB
+ *	18 bits = 15.625uV =  1 LSB
+ *	Die gelieferten Messergebnisse werden zusätzlich
+ *	auf Gain 8 normiert (1 LSB = 1.953125uV), damit
+ *	Ergebnisse mit unterschiedlichem Gain gemittelt
+ *	werden können.
+ */
+#define __LSB_VOLTAGE		(15.625E-6L / 8)
 
 static INLINE bool __cmpCFG(u8 nCFG1, u8 nCFG2) {
 	return ((nCFG1 & 0b01111111) == (nCFG2 & 0b01111111));
@@ -52,17 +152,26 @@ static i32 __fixSign(u8 nResolution, u32 nValue) {
 	return nReturn;
 }
 
-static ldbl __toVoltage(u8 nResolution, i32 nValue) {
+static i32 __normalize(u8 nResolution, i32 nValue) {
 	ASSERT(nResolution < 4);
 
-	ldbl dMeasuredVoltage = nValue * __dMultiplier[nResolution];
+	// Multiplikation statt Schieben wegen negativen Werten
+	return nValue * (i32)(1u << ((3 - nResolution) * 2));
+}
 
-	ASSERT(dMeasuredVoltage <= 2.048L);
+static INLINE i32 __applyGain(u8 nGain, i32 nValue) {
+	// Multiplikation statt Schieben wegen negativen Werten
+	return nValue * (i32)(1u << (3 - nGain));
+}
 
-	return dMeasuredVoltage;
+static INLINE bool __isSaturated(u8 nResolution, i32 nValue) {
+	// Grösster positiver Wert der Auflösung (in 18 Bit LSB)
+	i32 nMax = __FULL_SCALE - (i32)(1u << ((3 - nResolution) * 2));
+
+	return (nValue >= nMax || nValue <= -__FULL_SCALE);
 }
 
-static ldbl __unpack(u8 nCFG, u8 nReadBytes[static 3]) {
+static i32 __unpack(u8 nCFG, u8 nReadBytes[static 3]) {
 	u8 nResolution	= (nCFG & 0b00001100) >> 2u;
 	u32 nValue		= 0;
 	i32 nFixedValue	= 0;
@@ -90,8 +199,8 @@ static ldbl __unpack(u8 nCFG, u8 nReadBytes[static 3]) {
 	// Minuswerte behandeln
 	nFixedValue = __fixSign(nResolution, nValue);
 
-	// Wert in Spannung umrechnen
-	return __toVoltage(nResolution, nFixedValue);
+	// Wert auf 18 Bit LSB normieren
+	return __normalize(nResolution, nFixedValue);
 }
 // Statische Definitionen --------------------------------
 
@@ -108,83 +217,183 @@ void ExtADC__enable(void) {
  *	@function	ExtADC__startMeasurement
  */
 void ExtADC__startMeasurement(ExtADC_gain_t nGain, ExtADC_channel_t nCH, ExtADC_resolution_t nRes) {
-	ASSERT(nGain < 4);
+	INTERRUPTS_REQUIRED();
+	ASSERT(nGain <= ExtADCGainAuto);
 	ASSERT(nCH < 4);
 	ASSERT(nRes < 4);
 	ASSERT(__bStarted == FALSE);
 
 	{
-		u8 nCFG = 0b10000000;
+		// Dauerwandlungsmodus (O/C Bit gesetzt)
+		u8 nCFG = 0b00010000;
+
+		__bAutoGain = (nGain == ExtADCGainAuto);
+
+		if (__bAutoGain) {
+			nGain = __nAutoGain;
+		}
 
 		nCFG |= (nGain << 0u);
 		nCFG |= (nRes << 2u);
 		nCFG |= (nCH << 5u);
 
-		TWI__start();
-		TWI__selectSlave(__ADDR_W);
-		TWI__writeByte(nCFG);
+		if (__bConfigured == FALSE || nCFG != __nCFG) {
+			__configure(nCFG);
+		} else {
+			__nState = __STATE_WAIT;
+		}
+
+		__bStarted = TRUE;
+	}
+}
 
-		// Konfiguration lokal speichern
-		__nCFG = nCFG;
+/*!
+ *	@function	ExtADC__isDone
+ */
+bool ExtADC__isDone(Measure__readings_t *readings) {
+	bool bIsDone = FALSE;
 
-		TWI__repeatedStart();
-		TWI__selectSlave(__ADDR_R);
+	ASSERT(__bStarted == TRUE);
 
-		/*!
-		 *	Um das Konfigurationsregister lesen zu können
-		 *	muss erst das Messergebnis gelesen werden.
-		 */
-		(void)TWI__readByteACK();
-		(void)TWI__readByteACK();
-		(void)TWI__readByteACK();
+	if (__nState != __STATE_WAIT) {
+		// Transaktion läuft noch
+		if (__transaction.bDone == FALSE) {
+			return FALSE;
+		}
 
-		// Konfigurationsregister vergleichen
-		nCFG = TWI__readByteACK();
+		ASSERT(__transaction.bError == FALSE);
+	}
 
-		ASSERT(__cmpCFG(__nCFG, nCFG));
+	switch (__nState) {
+		case __STATE_CONFIG: {
+			__nState = __STATE_WAIT;
+		} break;
 
-		__bStarted = TRUE;
+		case __STATE_WAIT: {
+			u8 nResolution = (__nCFG & 0b00001100) >> 2u;
+
+			// Erst nach der Wandlungszeit ist ein neues Ergebnis vorhanden
+			if ((u16)(Timer__getTicks() - __nLastSample) >= __nWaitTime) {
+				// Messergebnis und Konfiguration in einem Durchgang lesen
+				__submit(NULL, 0, __numReadBytes(nResolution));
+
+				__nState = __STATE_READ;
+			}
+		} break;
+
+		case __STATE_READ: {
+			u8 nResolution	= (__nCFG & 0b00001100) >> 2u;
+			u8 nCFG			= __nReadBytes[__numReadBytes(nResolution) - 1];
+
+			// Prüfen ob Konfiguration richtig gespeichert wurde
+			ASSERT(__cmpCFG(nCFG, __nCFG));
+
+			// RDY Bit gelöscht = Ergebnis wurde noch nicht gelesen
+			bIsDone = !BIT_ISSET(nCFG, 7);
+
+			if (bIsDone) {
+				u8 nGain		= __nCFG & 0b00000011;
+				i32 nValue		= __unpack(nCFG, __nReadBytes);
+				i32 nMagnitude	= (nValue < 0) ? -nValue : nValue;
+
+				if (__bAutoGain) {
+					if (__isSaturated(nResolution, nValue) && nGain > ExtADCGain1) {
+						// Übersteuert: Ergebnis verwerfen, mit kleinerem Gain wiederholen
+						__nAutoGain = nGain - 1;
+
+						__configure((__nCFG & 0b11111100) | __nAutoGain);
+
+						return FALSE;
+					}
+
+					// Gain für die nächste Messung wählen
+					if (nMagnitude > __GAIN_DOWN_LIMIT && nGain > ExtADCGain1) {
+						__nAutoGain = nGain - 1;
+					} else if (nMagnitude < __GAIN_UP_LIMIT && nGain < ExtADCGain8) {
+						__nAutoGain = nGain + 1;
+					}
+				}
+
+				if (readings != NULL) {
+					Measure__setReading(readings, __applyGain(nGain, nValue));
+				}
+
+				__nLastGain		= nGain;
+				__nLastSample	= Timer__getTicks();
+				__nWaitTime		= pgm_read_word(&__nConversionTime[nResolution]);
+				__nState		= __STATE_WAIT;
+				__bStarted		= FALSE;
+
+				++__nSamples;
+			} else {
+				// Wandlung knapp noch nicht fertig, nach 1ms erneut lesen
+				__nLastSample	= Timer__getTicks();
+				__nWaitTime		= 1;
+				__nState		= __STATE_WAIT;
+			}
+		} break;
+
+		default: {
+			ASSERT(FALSE);
+		} break;
 	}
+
+	return bIsDone;
 }
 
 /*!
- *	@function	ExtADC__isDone
+ *	@function	ExtADC__getGain
+ */
+ExtADC_gain_t ExtADC__getGain(void) {
+	return __nLastGain;
+}
+
+/*!
+ *	@function	ExtADC__getBytesPerSample
  */
-bool ExtADC__isDone(ldbl *dResult) {
-	bool bIsDone;
-	u8 nCFG;
+ldbl ExtADC__getBytesPerSample(void) {
+	if (__nSamples == 0) {
+		return NAN;
+	}
 
-	// Konfiguration lesen
-	nCFG = TWI__readByteACK();
-	// Prüfen ob Konfiguration richtig gespeichert wurde
-	ASSERT(__cmpCFG(nCFG, __nCFG));
+	return (ldbl)__nBusBytes / __nSamples;
+}
+
+/*!
+ *	@function	ExtADC__toVoltage
+ */
+ldbl ExtADC__toVoltage(ldbl dRawResult) {
+	ldbl dMeasuredVoltage = dRawResult * __LSB_VOLTAGE;
 
-	// ADC fertig?
-	bIsDone = !BIT_ISSET(nCFG, 7);
+	ASSERT(dMeasuredVoltage <= 2.048L);
 
-	if (bIsDone) {
-		// Mit NACK Lesemodus beenden
-		(void)TWI__readByteNACK();
+	return dMeasuredVoltage;
+}
 
-		if (dResult != NULL) {
-			// Messergebnis holen
-			u8 nBytes[3];
+/*!
+ *	@function	ExtADC__disable
+ */
+void ExtADC__disable(void) {
+	INTERRUPTS_REQUIRED();
 
-			TWI__repeatedStart();
-			TWI__selectSlave(__ADDR_R);
+	// Laufende Transaktion abwarten
+	if (__nState != __STATE_WAIT) {
+		while (__transaction.bDone == FALSE);
+	}
 
-			nBytes[0] = TWI__readByteACK();
-			nBytes[1] = TWI__readByteACK();
-			nBytes[2] = TWI__readByteNACK();
+	/*!
+	 *	Einzelwandlungsmodus ohne Start (O/C und RDY Bit
+	 *	gelöscht), der ADC geht nach der laufenden
+	 *	Wandlung in den Standby.
+	 */
+	__nCFG &= 0b01101111;
 
-			*dResult = __unpack(nCFG, nBytes);
-		}
+	__submit(&__nCFG, 1, 0);
 
-		// I2C Bus befreien
-		TWI__stop();
+	while (__transaction.bDone == FALSE);
 
-		__bStarted = FALSE;
-	}
-	
-	return bIsDone;
+	__nState		= __STATE_WAIT;
+	__bStarted		= FALSE;
+	__bConfigured	= FALSE;
+	__bAutoGain		= FALSE;
 }
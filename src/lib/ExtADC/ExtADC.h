@@ -13,12 +13,15 @@
 	#define JAQ_EXTADC_H 1
 
 	#include <common/common.h>
+	#include <Measure/Measure.h>
 
 	enum ExtADC__gainSetting {
 		ExtADCGain1 = 0b00,
 		ExtADCGain2 = 0b01,
 		ExtADCGain4 = 0b10,
-		ExtADCGain8 = 0b11
+		ExtADCGain8 = 0b11,
+		// Automatische Wahl anhand des letzten Ergebnisses
+		ExtADCGainAuto = 0b100
 	};
 
 	enum ExtADC__channelSetting {
@@ -55,8 +58,14 @@
 	 *	@function	ExtADC__startMeasurement
 	 *	@brief
 	 *	Startet eine neue Messung mit dem externen ADC.
+	 *	Der ADC läuft im Dauerwandlungsmodus, die Konfiguration
+	 *	wird nur geschrieben wenn sie sich geändert hat.
 	 *
-	 *	@param		nGain		Gaineinstellung. (1x, 2x, 4x oder 8x)
+	 *	@param		nGain		Gaineinstellung. (1x, 2x, 4x, 8x oder automatisch)
+	 *	Bei `ExtADCGainAuto` wird der Gain anhand des letzten
+	 *	Ergebnisses mit Hysterese hoch- oder heruntergeschaltet.
+	 *	Die Auflösung wird dabei nicht umgeschaltet, sie bleibt
+	 *	fest wie mit `nRes` gewählt (measurements.c: 14 Bit).
 	 *	@param		nCH			Kanalselektion (Kanal 1 bis 4)
  	 *	@param		nRes		Auflösung (12, 14, 16 oder 18 Bits)
 	 *	12 Bit	~5ms
@@ -75,27 +84,77 @@
 	 *	@function	ExtADC__isDone
 	 *	@brief
 	 *	Prüft ob der externe ADC mit der Messung fertig ist.
+	 *	Das neueste Messergebnis wird erst gelesen wenn die
+	 *	Wandlungszeit seit dem letzten Ergebnis verstrichen ist.
 	 *
-	 *	@param		dResult		Wenn `dResult` nicht 'NULL' ist, wird das
-	 *	Ergebnis dort abgelegt. (Einheit: V)
+	 *	@param		readings	Wenn `readings` nicht 'NULL' ist, wird das
+	 *	Ergebnis dort abgelegt. (Einheit: 18 Bit LSB bei Gain 8, siehe ExtADC__toVoltage)
 	 *
 	 *	@return		bool
 	 *	'TRUE' wenn Messung fertig, ansonsten 'FALSE'.
 	 *
 	 *	@warning
 	 *		- ExtADC__startMeasurement muss vorher aufgerufen worden sein!
+	 *		- Timer__enable muss vorher aufgerufen worden sein!
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	bool ExtADC__isDone(ldbl *res);
+	bool ExtADC__isDone(Measure__readings_t *readings);
+
+	/*!
+	 *	@function	ExtADC__getGain
+	 *	@brief
+	 *	Gibt den Gain des zuletzt gelieferten Messergebnisses zurück.
+	 *
+	 *	@return		ExtADC_gain_t
+	 *	Verwendeter Gain (1x, 2x, 4x oder 8x).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	ExtADC_gain_t ExtADC__getGain(void);
+
+	/*!
+	 *	@function	ExtADC__getBytesPerSample
+	 *	@brief
+	 *	Gibt die durchschnittliche Anzahl übertragener I2C Bytes
+	 *	(inklusive Adressbytes) pro geliefertem Messergebnis zurück.
+	 *
+	 *	@return		ldbl
+	 *	Bytes pro Messergebnis oder 'NAN' falls noch kein
+	 *	Messergebnis geliefert wurde.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	ldbl ExtADC__getBytesPerSample(void);
+
+	/*!
+	 *	@function	ExtADC__toVoltage
+	 *	@brief
+	 *	Rechnet einen (gemittelten) Rohwert in eine Spannung um.
+	 *
+	 *	@param		dRawResult	Rohwert in LSB der 18 Bit Auflösung bei Gain 8.
+	 *
+	 *	@return		ldbl
+	 *	Spannung in V.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	ldbl ExtADC__toVoltage(ldbl dRawResult);
 
 	/*!
 	 *	@function	ExtADC__disable
 	 *	@brief
-	 *	Deaktiviert das ExtADC Modul.
+	 *	Deaktiviert das ExtADC Modul. Wartet die laufende
+	 *	Transaktion ab und schaltet den ADC in den
+	 *	Einzelwandlungsmodus, danach geht er in den Standby.
+	 *	Der nächste Aufruf von ExtADC__startMeasurement
+	 *	schreibt die Konfiguration neu.
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
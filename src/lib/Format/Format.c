@@ -0,0 +1,134 @@
+/*!
+ *	@file		Format.c
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#include <Format/Format.h>
+
+// Statische Definitionen --------------------------------
+// SI-Präfixe von 10^-9 bis 10^9, Index 3 ohne Präfix
+#define __PREFIX_NONE	3u
+#define __PREFIX_MAX	6u
+
+static const char __cPrefixes[__PREFIX_MAX + 1] PROGMEM = {'n', 'u', 'm', 0, 'k', 'M', 'G'};
+
+static const u32 __nPowers[FORMAT_MAX_DECIMALS + 1] PROGMEM = {
+	1ul, 10ul, 100ul, 1000ul, 10000ul, 100000ul, 1000000ul
+};
+
+/*!
+ *	Hängt ein Zeichen an, falls im Puffer noch
+ *	Platz (inklusive Nullterminierung) ist.
+ */
+static INLINE void __put(char *sBuffer, u8 nSize, u8 *nLength, char cChar) {
+	if (*nLength + 1u < nSize) {
+		sBuffer[(*nLength)++] = cChar;
+	}
+}
+
+static u8 __puts(char *sBuffer, u8 nSize, u8 nLength, const char *sStr) {
+	if (sStr) {
+		while (*sStr) {
+			__put(sBuffer, nSize, &nLength, *sStr++);
+		}
+	}
+
+	sBuffer[nLength] = '\0';
+
+	return nLength;
+}
+// Statische Definitionen --------------------------------
+
+/*!
+ *	@function	Format__fixed
+ */
+u8 Format__fixed(char *sBuffer, u8 nSize, i32 nValue, u8 nDecimals) {
+	char cDigits[10];
+	u8 nDigits	= 0;
+	u8 nLength	= 0;
+	u32 nAbs	= (nValue < 0 ? -(u32)nValue : (u32)nValue);
+
+	ASSERT(sBuffer != NULL && nSize > 0);
+	ASSERT(nDecimals <= FORMAT_MAX_DECIMALS);
+
+	// Ziffern rückwärts, mindestens eine Stelle vor dem Komma
+	do {
+		cDigits[nDigits++] = '0' + (char)(nAbs % 10u);
+		nAbs /= 10u;
+	} while (nAbs > 0 || nDigits <= nDecimals);
+
+	if (nValue < 0) {
+		__put(sBuffer, nSize, &nLength, '-');
+	}
+
+	while (nDigits > 0) {
+		if (nDigits == nDecimals) {
+			__put(sBuffer, nSize, &nLength, '.');
+		}
+
+		__put(sBuffer, nSize, &nLength, cDigits[--nDigits]);
+	}
+
+	sBuffer[nLength] = '\0';
+
+	return nLength;
+}
+
+/*!
+ *	@function	Format__SI
+ */
+u8 Format__SI(char *sBuffer, u8 nSize, ldbl dValue, u8 nDecimals, const char *sUnit) {
+	u8 nPrefix	= __PREFIX_NONE;
+	u8 nLength;
+	ldbl dAbs;
+	u32 nScaled;
+	u32 nPower;
+	char cPrefix;
+
+	ASSERT(sBuffer != NULL && nSize > 0);
+	ASSERT(nDecimals <= FORMAT_MAX_DECIMALS);
+
+	// NAN ist ungleich sich selbst
+	if (dValue != dValue) {
+		return __puts(sBuffer, nSize, 0, "---");
+	}
+
+	dAbs = (dValue < 0 ? -dValue : dValue);
+
+	if (dAbs > 0) {
+		while (dAbs >= 1000.0L && nPrefix < __PREFIX_MAX) {
+			dAbs /= 1000.0L;
+			++nPrefix;
+		}
+
+		while (dAbs < 1.0L && nPrefix > 0) {
+			dAbs *= 1000.0L;
+			--nPrefix;
+		}
+	}
+
+	// Auch 10^9 * 999.999 passt nicht mehr
+	if (dAbs >= 1000.0L) {
+		return __puts(sBuffer, nSize, 0, "---");
+	}
+
+	nPower	= pgm_read_dword(&__nPowers[nDecimals]);
+	nScaled	= (u32)(dAbs * nPower + 0.5L);
+
+	// Durch Runden kann 1000 erreicht werden (999.9996 -> 1000.000)
+	if (nScaled >= 1000ul * nPower && nPrefix < __PREFIX_MAX) {
+		nScaled = (nScaled + 500ul) / 1000ul;
+		++nPrefix;
+	}
+
+	nLength = Format__fixed(sBuffer, nSize, (dValue < 0 ? -(i32)nScaled : (i32)nScaled), nDecimals);
+
+	cPrefix = pgm_read_byte(&__cPrefixes[nPrefix]);
+
+	if (cPrefix != 0) {
+		__put(sBuffer, nSize, &nLength, cPrefix);
+	}
+
+	return __puts(sBuffer, nSize, nLength, sUnit);
+}
@@ -0,0 +1,68 @@
+/*!
+ *	@file		Format.h
+ *	@brief
+ *	Dieses Modul formatiert Messwerte als Festkommazahlen,
+ *	ohne die Gleitkomma-Variante von printf (printf_flt).
+ *	Die Zahl wird einmal in eine Ganzzahl umgewandelt, alle
+ *	weiteren Schritte rechnen nur noch mit Ganzzahlen.
+ *
+ *	Beispiel:
+ *	Format__fixed(sBuffer, sizeof(sBuffer), -12345, 3);
+ *	ergibt "-12.345".
+ *	Format__SI(sBuffer, sizeof(sBuffer), 0.0123, 3, "A");
+ *	ergibt "12.300mA".
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#if !defined(JAQ_FORMAT_H)
+	#define JAQ_FORMAT_H 1
+
+	#include <common/common.h>
+
+	// Maximale Anzahl Nachkommastellen
+	#define FORMAT_MAX_DECIMALS		6u
+
+	/*!
+	 *	@function	Format__fixed
+	 *	@brief
+	 *	Schreibt die Festkommazahl `nValue` * 10^-`nDecimals`
+	 *	in `sBuffer`. Zu lange Ausgaben werden abgeschnitten,
+	 *	der Puffer ist immer nullterminiert.
+	 *
+	 *	@param		sBuffer		Zielpuffer.
+	 *	@param		nSize		Grösse des Zielpuffers.
+	 *	@param		nValue		Wert in Einheiten der letzten Stelle.
+	 *	@param		nDecimals	Anzahl Nachkommastellen.
+	 *
+	 *	@return		u8
+	 *	Anzahl geschriebene Zeichen (ohne Nullterminierung).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u8 Format__fixed(char *sBuffer, u8 nSize, i32 nValue, u8 nDecimals);
+
+	/*!
+	 *	@function	Format__SI
+	 *	@brief
+	 *	Schreibt `dValue` mit SI-Präfix (n, u, m, k, M, G) und
+	 *	der Einheit `sUnit` in `sBuffer`. Der Präfix wird so
+	 *	gewählt, dass vor dem Komma eine bis drei Stellen stehen.
+	 *	Ungültige Werte (NAN) werden als "---" ausgegeben.
+	 *
+	 *	@param		sBuffer		Zielpuffer.
+	 *	@param		nSize		Grösse des Zielpuffers.
+	 *	@param		dValue		Wert in der Grundeinheit.
+	 *	@param		nDecimals	Anzahl Nachkommastellen (max. FORMAT_MAX_DECIMALS).
+	 *	@param		sUnit		Einheit oder NULL.
+	 *
+	 *	@return		u8
+	 *	Anzahl geschriebene Zeichen (ohne Nullterminierung).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u8 Format__SI(char *sBuffer, u8 nSize, ldbl dValue, u8 nDecimals, const char *sUnit);
+
+#endif // !defined(JAQ_FORMAT_H)
@@ -5,22 +5,113 @@
  *	@copyright	2016 <Marco Agnoli>
  */
 #include <FreqCounter/FreqCounter.h>
+#include <Timer/Timer.h>	// Timer__*
+#include <avr/eeprom.h>		// eeprom_*
 
 // Statische Definitionen --------------------------------
 static volatile u32 __nOverflows	= 0;
 static volatile bool __bIsDone		= TRUE;
 static volatile bool __bStarted		= FALSE;
 
+static FreqCounter_mode_t __nMode	= FreqCounterSinglePeriod;
+
+/*!
+ *	Im Mehrperiodenmodus wird der Zähler bei Flanke 0
+ *	gestartet und bei Flanke N gestoppt.
+ *	N wird aus der letzten Periodendauer so gewählt,
+ *	dass eine Messung etwa `__TARGET_TICKS` dauert.
+ */
+#define __TARGET_TICKS		320000ul	// 20ms
+#define __MAX_PERIODS		255u
+
+static volatile u8 __nPeriods		= 1;
+static volatile u8 __nEdges			= 0;
+static u8 __nNextPeriods			= 1;
+
+static u8 __choosePeriods(u32 nPeriod) {
+	u32 nPeriods = __TARGET_TICKS / nPeriod;
+
+	if (nPeriods < 1) {
+		return 1;
+	} else if (nPeriods > __MAX_PERIODS) {
+		return __MAX_PERIODS;
+	}
+
+	return nPeriods;
+}
+
+/*!
+ *	Im Torzeitmodus wird reziprok gezählt: Das Tor öffnet
+ *	mit einer Flanke und schliesst nach Ablauf von
+ *	`__GATE_TIME` mit der nächsten Flanke. Timer/Counter0
+ *	misst die Zeit zwischen diesen beiden Flanken, es gibt
+ *	also keinen Fehler von ±1 Flanke wie beim Zählen
+ *	während einer festen Torzeit.
+ */
+#define __GATE_TIME			100u		// ms
+#define __F_TIMER0			16000000ul	// Hz
+
+static volatile bool __bGate		= FALSE;
+static volatile bool __bGateExpired	= FALSE;
+static volatile u16 __nGateEdges	= 0;
+static Timer__ID_t __nGateTimer;
+static bool __bGateTimerCreated		= FALSE;
+
+/*!
+ *	Im automatischen Modus wird oberhalb der Übergangsfrequenz
+ *	der Torzeitmodus, darunter der Mehrperiodenmodus verwendet.
+ *	Die Umschaltung erfolgt mit 10% Hysterese.
+ */
+static u32 __nCrossoverTicks		= __F_TIMER0 / 2000u;
+static bool __bAutoGate				= FALSE;
+
+/*!
+ *	Korrektur der Zählerwerte (siehe FreqCounter__setCorrection).
+ *	Im EEPROM gespeichert, damit sie nach dem Einschalten
+ *	sofort gilt.
+ */
+#define __CORRECTION_MAGIC	0xCA1Bu
+
+struct __correction {
+	u16		nMagic;
+	i32		nOffset;
+	i32		nScalePPM;
+};
+
+typedef		struct __correction		__correction_t;
+
+static __correction_t __eeCorrection EEMEM;
+static __correction_t __correction	= {__CORRECTION_MAGIC, 0, 0};
+
+static u32 __correct(u32 nTimerValue) {
+	i32 nValue = nTimerValue;
+
+	// Latenz der ISR bei Start und Stopp durch INT2
+	nValue -= __correction.nOffset;
+
+	nValue -= ((i64)nValue * __correction.nScalePPM) / 1000000l;
+
+	return (nValue > 0) ? (u32)nValue : 0;
+}
+
+static void __updateAutoGate(u32 nPeriod) {
+	if (__bAutoGate == TRUE && nPeriod > __nCrossoverTicks + __nCrossoverTicks / 10) {
+		__bAutoGate = FALSE;
+	} else if (__bAutoGate == FALSE && nPeriod < __nCrossoverTicks - __nCrossoverTicks / 10) {
+		__bAutoGate = TRUE;
+	}
+}
+
 static INLINE void __ExtINT2_enable(void) {
-	// Aufruf von ISR verhindern
-	GIFR |= _BV(INTF2);
+	// Aufruf von ISR verhindern (Flag wird mit 1 gelöscht)
+	GIFR = _BV(INTF2);
 	GICR |= _BV(INT2);
 }
 
 static INLINE void __ExtINT2_disable(void) {
 	GICR &= ~_BV(INT2);
-	// Aufruf von ISR verhindern
-	GIFR |= _BV(INTF2);
+	// Aufruf von ISR verhindern (Flag wird mit 1 gelöscht)
+	GIFR = _BV(INTF2);
 }
 
 static INLINE bool __ExtINT2_isEnabled(void) {
@@ -35,13 +126,28 @@ static INLINE void __Timer0_start(void) {
 static INLINE void __Timer0_stop(void) {
 	// Zähler stoppen
 	TCCR0 = 0x00;
-	// Aufruf von ISR verhindern
-	TIFR |= _BV(TOV0);
+	// Aufruf von ISR verhindern (Flag wird mit 1 gelöscht)
+	TIFR = _BV(TOV0);
 }
 
 static INLINE bool __Timer0_isRunning(void) {
 	return TCCR0 != 0x00;
 }
+
+/*!
+ *	Stoppt den Zähler bei der letzten Flanke. Ein Überlauf,
+ *	dessen ISR noch nicht aufgerufen wurde, wird mitgezählt.
+ *	Wird in der INT2 ISR aufgerufen.
+ */
+static INLINE void __Timer0_stopAtEdge(void) {
+	TCCR0 = 0x00;
+
+	if (BIT_ISSET(TIFR, TOV0)) {
+		++__nOverflows;
+
+		TIFR = _BV(TOV0);
+	}
+}
 // Statische Definitionen --------------------------------
 
 /*!
@@ -91,8 +197,19 @@ ISR(INT2_vect, ISR_BLOCK) {
 	ASSERT(__bIsDone == FALSE);
 
 	if (__Timer0_isRunning()) {
-		// Bei der zweiten Flanke muss der Zähler gestoppt werden
-		__Timer0_stop();
+		if (__bGate) {
+			// Flanken zählen bis die Torzeit abgelaufen ist
+			if (++__nGateEdges < 0xFFFFu && __bGateExpired == FALSE) {
+				return;
+			}
+		} else
+		// Zwischenflanken nur zählen
+		if (++__nEdges < __nPeriods) {
+			return;
+		}
+
+		// Bei der letzten Flanke muss der Zähler gestoppt werden
+		__Timer0_stopAtEdge();
 		__ExtINT2_disable();
 		// Flag setzen
 		__bIsDone = TRUE;
@@ -102,6 +219,9 @@ ISR(INT2_vect, ISR_BLOCK) {
 		ASSERT(__nOverflows == 0);
 
 		__Timer0_start();
+
+		__nEdges		= 0;
+		__nGateEdges	= 0;
 	}
 }
 
@@ -118,6 +238,12 @@ void FreqCounter__enable(void) {
 	TIMSK |= _BV(TOIE0);
 	// Der externe Interrupt soll bei positive Flanken ausgelöst werden
 	MCUCSR |= _BV(ISC2);
+
+	// Zeitgeber für die Torzeit, nur beim ersten Aufruf anlegen
+	if (__bGateTimerCreated == FALSE) {
+		__nGateTimer		= Timer__create();
+		__bGateTimerCreated	= TRUE;
+	}
 }
 
 /*!
@@ -136,23 +262,39 @@ void FreqCounter__startMeasurement(void) {
 	TCNT0			= 0x00;	// Zählerwert auf 0 setzen
 	__nOverflows	= 0;	// Überlaufzähler zurücksetzen
 
+	// Anzahl Perioden pro Messung
+	__nPeriods		= (__nMode == FreqCounterSinglePeriod) ? 1 : __nNextPeriods;
+	__bGate			= (__nMode == FreqCounterGate || (__nMode == FreqCounterAuto && __bAutoGate));
+	__bGateExpired	= FALSE;
+	__nGateEdges	= 0;
+
 	// Überlaufinterrupt muss aktiviert sein
 	ASSERT(BIT_ISSET(TIMSK, TOIE0));
 
 	__bIsDone		= FALSE;// Flag zurücksetzen
 	__bStarted		= TRUE;
 
+	// Der Zähler startet mit der ersten Flanke (siehe INT2_vect)
+	if (__bGate) {
+		Timer__start(__nGateTimer, __GATE_TIME);
+	}
+
 	__ExtINT2_enable();
 }
 
 /*!
  *	@function	FreqCounter__isDone
  */
-bool FreqCounter__isDone(ldbl *dResult) {
+bool FreqCounter__isDone(Measure__readings_t *readings) {
 	INTERRUPTS_REQUIRED();
 	// Es muss eine Messung gestartet worden sein
 	ASSERT(__bStarted == TRUE);
 
+	// Nach Ablauf der Torzeit schliesst die nächste Flanke das Tor
+	if (__bGate && __bGateExpired == FALSE && Timer__hasExpired(__nGateTimer)) {
+		__bGateExpired = TRUE;
+	}
+
 	// Flag sofort kopieren
 	bool bIsDone = __bIsDone;
 
@@ -167,25 +309,51 @@ bool FreqCounter__isDone(ldbl *dResult) {
 			ASSERT(!__ExtINT2_isEnabled());
 			ASSERT(!__Timer0_isRunning());
 
-			if (dResult != NULL) {
-				ldbl _dResult;
+			// Zählerwert lesen
+			u32 nTimerValue = TCNT0;
+
+			// Überläufe dazuaddieren
+			// << 8 ist gleichwertig mit Multiplikation von 256
+			nTimerValue += ((u32)__nOverflows << 8ul);
+
+			if (nTimerValue > 0) {
+				nTimerValue = __correct(nTimerValue);
+			}
 
-				// Zählerwert lesen
-				u32 nTimerValue = TCNT0;
-	
-				// Überläufe dazuaddieren
-				// << 8 ist gleichwertig mit Multiplikation von 256
-				nTimerValue += ((u32)__nOverflows << 8ul);
+			// Anzahl gemessene Perioden
+			u16 nNumPeriods = (__bGate) ? __nGateEdges : __nPeriods;
 
-				// Frequenz aus Zählerwert errechnen:
-				// f = (1 / (nTimerValue * 62.5ns))
-				_dResult = 1.0L / (((ldbl)nTimerValue * 62.5E-9L));
+			if (nTimerValue == 0 || nNumPeriods == 0) {
+				// Abgebrochene Messung, wieder mit einer Periode beginnen
+				__nNextPeriods	= 1;
+				__bAutoGate		= FALSE;
 
-				if (!isfinite(_dResult)) {
-					_dResult = 0.0;
+				if (readings != NULL) {
+					Measure__setReading(readings, 0);
+				}
+			} else {
+				u32 nPeriod = nTimerValue / nNumPeriods;
+
+				if (readings != NULL) {
+					/*!
+					 *	Die Messdauer von N Perioden wird als
+					 *	Summe von N Periodendauern (62.5ns) abgelegt,
+					 *	damit beim Mitteln keine Nachkommastellen
+					 *	verloren gehen. Die einzelnen Perioden sind
+					 *	nicht bekannt, sie gelten als gleich lang.
+					 *	Im Torzeitmodus ist N die Anzahl Perioden
+					 *	zwischen Öffnen und Schliessen des Tores.
+					 */
+					readings->nSum		= nTimerValue;
+					readings->nNum		= nNumPeriods;
+					readings->nMin		= nPeriod;
+					readings->nMax		= nPeriod;
+					readings->nSquares	= 0;
 				}
 
-				*dResult = _dResult;
+				__nNextPeriods = __choosePeriods(nPeriod);
+
+				__updateAutoGate(nPeriod);
 			}
 
 			__bStarted = FALSE;
@@ -195,11 +363,105 @@ bool FreqCounter__isDone(ldbl *dResult) {
 	return bIsDone;
 }
 
+/*!
+ *	@function	FreqCounter__setMode
+ */
+void FreqCounter__setMode(FreqCounter_mode_t nMode) {
+	ASSERT(__bStarted == FALSE);
+	ASSERT(nMode <= FreqCounterAuto);
+
+	__nMode			= nMode;
+	__nNextPeriods	= 1;
+	__bAutoGate		= FALSE;
+}
+
+/*!
+ *	@function	FreqCounter__setCrossover
+ */
+void FreqCounter__setCrossover(u16 nFrequency) {
+	ASSERT(nFrequency > 0);
+
+	__nCrossoverTicks = __F_TIMER0 / nFrequency;
+}
+
+/*!
+ *	@function	FreqCounter__setCorrection
+ */
+void FreqCounter__setCorrection(i32 nOffset, i32 nScalePPM) {
+	__correction.nOffset	= nOffset;
+	__correction.nScalePPM	= nScalePPM;
+}
+
+/*!
+ *	@function	FreqCounter__storeCorrection
+ */
+void FreqCounter__storeCorrection(void) {
+	__correction.nMagic = __CORRECTION_MAGIC;
+
+	eeprom_update_block(&__correction, &__eeCorrection, sizeof(__correction_t));
+}
+
+/*!
+ *	@function	FreqCounter__loadCorrection
+ */
+bool FreqCounter__loadCorrection(void) {
+	__correction_t correction;
+
+	eeprom_read_block(&correction, &__eeCorrection, sizeof(__correction_t));
+
+	// Ungültiger Inhalt (z.B. gelöschtes EEPROM)
+	if (correction.nMagic != __CORRECTION_MAGIC) {
+		return FALSE;
+	}
+
+	__correction = correction;
+
+	return TRUE;
+}
+
+/*!
+ *	@function	FreqCounter__abort
+ */
+void FreqCounter__abort(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__ExtINT2_disable();
+		__Timer0_stop();
+
+		TCNT0			= 0x00;
+		__nOverflows	= 0;
+		__bIsDone		= TRUE;
+		__bStarted		= FALSE;
+	}
+
+	if (__bGate) {
+		Timer__stop(__nGateTimer);
+	}
+}
+
+/*!
+ *	@function	FreqCounter__toFrequency
+ */
+ldbl FreqCounter__toFrequency(ldbl dRawResult) {
+	// Abgebrochene Messung (0 Zählerschritte) entspricht 0Hz
+	if (dRawResult < 1.0L) {
+		return 0.0L;
+	}
+
+	// Frequenz aus Zählerwert errechnen:
+	// f = (1 / (nTimerValue * 62.5ns))
+	return 1.0L / (dRawResult * 62.5E-9L);
+}
+
 /*!
  *	@function	FreqCounter__disable
  */
 void FreqCounter__disable(void) {
 	__ExtINT2_disable();
+
+	if (__bGate) {
+		Timer__stop(__nGateTimer);
+	}
+
 	// Überlaufinterrupt deaktivieren
 	TIMSK &= ~_BV(TOIE0);
 	__Timer0_stop();
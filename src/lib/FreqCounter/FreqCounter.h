@@ -26,12 +26,29 @@
 	#define JAQ_FREQCOUNTER_H 1
 
 	#include <common/common.h>
+	#include <Measure/Measure.h>
+
+	enum FreqCounter__mode {
+		// Zeit zwischen zwei Flanken messen
+		FreqCounterSinglePeriod = 0,
+		// Zeit zwischen Flanke 0 und Flanke N messen
+		FreqCounterMultiPeriod = 1,
+		// Reziprok zählen: ganze Perioden während mindestens 100ms
+		FreqCounterGate = 2,
+		// Je nach Frequenz Mehrperioden- oder Torzeitmodus
+		FreqCounterAuto = 3
+	};
+
+	typedef		enum FreqCounter__mode		FreqCounter_mode_t;
 
 	/*!
 	 *	@function	FreqCounter__enable
 	 *	@brief
 	 *	Aktiviert den Frequenzzähler.
 	 *
+	 *	@warning
+	 *		- Legt einen Zeitgeber an (siehe Timer__create)!
+	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
 	 *	@date		11.05.2016
@@ -56,8 +73,11 @@
 	 *	@brief
 	 *	Prüft ob die Frequenzmessung fertiggestellt wurde.
 	 *
-	 *	@param		dResult		Wenn dResult nicht 'NULL' ist, wird das
-	 *	Ergebnis dort abgelegt. (Einheit: Hz)
+	 *	@param		readings	Wenn readings nicht 'NULL' ist, wird die
+	 *	Periodendauer dort abgelegt. (Einheit: 62.5ns, siehe FreqCounter__toFrequency)
+	 *	Im Mehrperiodenmodus wird die Messdauer als Summe von N Perioden abgelegt,
+	 *	im Torzeitmodus die Zeit zwischen den Flanken beim Öffnen
+	 *	und Schliessen des Tores als Summe der gezählten Perioden.
 	 *
 	 *	@return		bool
 	 *	'TRUE' wenn Messung fertig, ansonsten 'FALSE'.
@@ -70,7 +90,109 @@
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	bool FreqCounter__isDone(ldbl *dResult);
+	bool FreqCounter__isDone(Measure__readings_t *readings);
+
+	/*!
+	 *	@function	FreqCounter__setMode
+	 *	@brief
+	 *	Wählt den Messmodus.
+	 *	Im Mehrperiodenmodus wird die Zeit zwischen Flanke 0
+	 *	und Flanke N gemessen. N wird aus der letzten gemessenen
+	 *	Periodendauer gewählt, so dass eine Messung etwa 20ms dauert.
+	 *	Im Torzeitmodus öffnet das Tor mit einer Flanke und schliesst
+	 *	nach 100ms mit der nächsten Flanke, gemessen wird die Zeit
+	 *	zwischen diesen beiden Flanken (reziproke Zählung).
+	 *	Im automatischen Modus wird oberhalb der Übergangsfrequenz
+	 *	(siehe FreqCounter__setCrossover) im Torzeitmodus gemessen.
+	 *
+	 *	@param		nMode		Messmodus.
+	 *
+	 *	@warning
+	 *		- Es darf keine Messung laufen!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void FreqCounter__setMode(FreqCounter_mode_t nMode);
+
+	/*!
+	 *	@function	FreqCounter__setCrossover
+	 *	@brief
+	 *	Setzt die Übergangsfrequenz für den automatischen Modus.
+	 *	Die Umschaltung erfolgt mit 10% Hysterese. (Standard: 2kHz)
+	 *
+	 *	@param		nFrequency	Übergangsfrequenz in Hz.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void FreqCounter__setCrossover(u16 nFrequency);
+
+	/*!
+	 *	@function	FreqCounter__setCorrection
+	 *	@brief
+	 *	Setzt die Korrektur der gemessenen Zählerwerte:
+	 *	korrigiert = (roh - nOffset) * (1 - nScalePPM / 1E6)
+	 *	Der Offset gilt pro Messung und gleicht die Latenz
+	 *	der INT2 ISR beim Starten und Stoppen des Zählers aus.
+	 *
+	 *	@param		nOffset		Offset in Zählerschritten (62.5ns).
+	 *	@param		nScalePPM	Skalierungsfehler in ppm.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void FreqCounter__setCorrection(i32 nOffset, i32 nScalePPM);
+
+	/*!
+	 *	@function	FreqCounter__storeCorrection
+	 *	@brief
+	 *	Speichert die aktuelle Korrektur im EEPROM.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void FreqCounter__storeCorrection(void);
+
+	/*!
+	 *	@function	FreqCounter__loadCorrection
+	 *	@brief
+	 *	Lädt die Korrektur aus dem EEPROM.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls eine gültige Korrektur gespeichert war,
+	 *	ansonsten 'FALSE' (Korrektur bleibt unverändert).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool FreqCounter__loadCorrection(void);
+
+	/*!
+	 *	@function	FreqCounter__abort
+	 *	@brief
+	 *	Bricht eine laufende Messung ab, z.B. wenn
+	 *	innerhalb einer Zeitlimite keine Flanke kommt.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void FreqCounter__abort(void);
+
+	/*!
+	 *	@function	FreqCounter__toFrequency
+	 *	@brief
+	 *	Rechnet eine (gemittelte) Periodendauer in eine Frequenz um.
+	 *
+	 *	@param		dRawResult	Periodendauer in Zählerschritten (62.5ns).
+	 *
+	 *	@return		ldbl
+	 *	Frequenz in Hz.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	ldbl FreqCounter__toFrequency(ldbl dRawResult);
 
 	/*!
 	 *	@function	FreqCounter__disable
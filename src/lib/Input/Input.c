@@ -0,0 +1,170 @@
+/*!
+ *	@file		Input.c
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#include <Input/Input.h>
+#include <Timer/Timer.h>	// Timer__*
+
+// Statische Definitionen --------------------------------
+#define __QUEUE_SIZE	8u
+
+// Abtastungen bis zum langen Drücken
+#define __LONG_SAMPLES	(INPUT_LONG_PRESS / INPUT_SAMPLE_PERIOD)
+
+static Input__event_t __events[__QUEUE_SIZE];
+static volatile u8 __nHead			= 0;
+static volatile u8 __nLength		= 0;
+static volatile u16 __nLost			= 0;
+
+// Abgetastete Taster
+static u8 __nMask					= 0;
+// Entprellter Zustand (1 = gedrückt)
+static volatile u8 __nState			= 0;
+
+/*!
+ *	Vertikaler Zähler: Bit n von `__nCount0` und `__nCount1`
+ *	bilden zusammen einen 2 Bit Zähler für den Taster n.
+ */
+static u8 __nCount0					= 0xFF;
+static u8 __nCount1					= 0xFF;
+
+// Dauer des Drückens in Abtastungen
+static u8 __nHeld[8];
+
+/*!
+ *	Reiht ein Ereignis ein. Wird in der ISR aufgerufen.
+ */
+static void __push(u8 nKey, Input_type_t nType) {
+	u8 nTail;
+
+	if (__nLength == __QUEUE_SIZE) {
+		++__nLost;
+
+		return;
+	}
+
+	nTail = __nHead + __nLength;
+
+	if (nTail >= __QUEUE_SIZE) {
+		nTail -= __QUEUE_SIZE;
+	}
+
+	__events[nTail].nKey	= nKey;
+	__events[nTail].nType	= nType;
+
+	++__nLength;
+}
+
+/*!
+ *	Wird alle INPUT_SAMPLE_PERIOD ms vom Timer (ISR) aufgerufen.
+ */
+static void __sample(Timer__ID_t nTimer) {
+	// Aktiv tief: 1 = gedrückt
+	u8 nChanged = __nState ^ (~PIND & __nMask);
+
+	/*!
+	 *	Zähler der unveränderten Taster auf 3 setzen, die
+	 *	anderen herunterzählen. Erst beim Überlauf von 0
+	 *	wechselt der entprellte Zustand.
+	 */
+	__nCount0	= ~(__nCount0 & nChanged);
+	__nCount1	= __nCount0 ^ (__nCount1 & nChanged);
+	nChanged	&= __nCount0 & __nCount1;
+
+	__nState ^= nChanged;
+
+	for (u8 nKey = 0; nKey < 8; ++nKey) {
+		if (!BIT_ISSET(__nMask, nKey)) continue;
+
+		if (BIT_ISSET(nChanged, nKey)) {
+			if (BIT_ISSET(__nState, nKey)) {
+				__nHeld[nKey] = 0;
+
+				__push(nKey, InputPress);
+			} else {
+				__push(nKey, InputRelease);
+			}
+		} else if (BIT_ISSET(__nState, nKey) && __nHeld[nKey] < __LONG_SAMPLES) {
+			// Langes Drücken nur einmal melden
+			if (++__nHeld[nKey] == __LONG_SAMPLES) {
+				__push(nKey, InputLongPress);
+			}
+		}
+	}
+}
+// Statische Definitionen --------------------------------
+
+/*!
+ *	@function	Input__enable
+ */
+void Input__enable(u8 nMask) {
+	Timer__ID_t nTimer;
+
+	INTERRUPTS_REQUIRED();
+	ASSERT(__nMask == 0 && nMask != 0);
+
+	// Taster als Eingänge
+	DDRD &= ~nMask;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__nMask		= nMask;
+		__nState	= ~PIND & nMask;
+
+		// Bereits gedrückte Taster melden kein langes Drücken
+		memset(__nHeld, __LONG_SAMPLES, sizeof(__nHeld));
+	}
+
+	nTimer = Timer__create();
+
+	Timer__setCallback(nTimer, __sample);
+	Timer__startPeriodic(nTimer, INPUT_SAMPLE_PERIOD);
+}
+
+/*!
+ *	@function	Input__read
+ */
+bool Input__read(Input__event_t *event) {
+	bool bRead = FALSE;
+
+	ASSERT(event != NULL);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (__nLength > 0) {
+			*event = __events[__nHead];
+
+			if (++__nHead == __QUEUE_SIZE) {
+				__nHead = 0;
+			}
+
+			--__nLength;
+
+			bRead = TRUE;
+		}
+	}
+
+	return bRead;
+}
+
+/*!
+ *	@function	Input__isPressed
+ */
+bool Input__isPressed(u8 nKey) {
+	ASSERT(nKey < 8);
+
+	return BIT_ISSET(__nState, nKey);
+}
+
+/*!
+ *	@function	Input__getLost
+ */
+u16 Input__getLost(void) {
+	u16 nLost;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		nLost = __nLost;
+	}
+
+	return nLost;
+}
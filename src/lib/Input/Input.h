@@ -0,0 +1,116 @@
+/*!
+ *	@file		Input.h
+ *	@brief
+ *	Entprellte Taster an PORTD. Die Eingänge werden vom Timer
+ *	alle INPUT_SAMPLE_PERIOD ms abgetastet und mit einem
+ *	vertikalen Zähler entprellt: Ein Taster wechselt seinen
+ *	Zustand erst, wenn vier Abtastungen nacheinander den
+ *	neuen Pegel zeigen. Die Taster sind aktiv tief.
+ *
+ *	Drücken, Loslassen und langes Drücken werden als Ereignisse
+ *	in eine Warteschlange eingereiht. Ereignisse gehen auch dann
+ *	nicht verloren, wenn das Hauptprogramm länger blockiert ist.
+ *
+ *	Beispiel:
+ *	Input__enable(_BV(PD0) | _BV(PD1));
+ *	while (Input__read(&event)) {
+ *		if (event.nKey == PD0 && event.nType == InputPress) { ... }
+ *	}
+ *
+ *	@warning
+ *		- Timer__enable muss vorher aufgerufen worden sein!
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#if !defined(JAQ_INPUT_H)
+	#define JAQ_INPUT_H 1
+
+	#include <common/common.h>
+
+	// Abtastperiode in ms (Entprellzeit = 4 Perioden)
+	#define INPUT_SAMPLE_PERIOD		5u
+	// Dauer bis zum langen Drücken in ms
+	#define INPUT_LONG_PRESS		1000u
+
+	/*!
+	 *	Art des Ereignisses.
+	 */
+	enum Input_type {
+		InputPress		= 0,
+		InputRelease	= 1,
+		InputLongPress	= 2
+	};
+
+	typedef		enum Input_type		Input_type_t;
+
+	/*!
+	 *	Ein Tasterereignis.
+	 */
+	struct Input__event {
+		// Pin an PORTD (z.B. PD0)
+		u8				nKey;
+		Input_type_t	nType;
+	};
+
+	typedef		struct Input__event		Input__event_t;
+
+	/*!
+	 *	@function	Input__enable
+	 *	@brief
+	 *	Aktiviert die Abtastung der Taster `nMask` an PORTD.
+	 *	Der aktuelle Zustand gilt als Ausgangszustand, bereits
+	 *	gedrückte Taster erzeugen kein Ereignis.
+	 *
+	 *	@param		nMask		Bitmaske der Taster (PINx).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Input__enable(u8 nMask);
+
+	/*!
+	 *	@function	Input__read
+	 *	@brief
+	 *	Holt das älteste Ereignis ab.
+	 *
+	 *	@param		event		Hier wird das Ereignis abgelegt.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls ein Ereignis abgeholt wurde, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Input__read(Input__event_t *event);
+
+	/*!
+	 *	@function	Input__isPressed
+	 *	@brief
+	 *	Gibt den entprellten Zustand des Tasters `nKey` zurück.
+	 *
+	 *	@param		nKey		Pin an PORTD.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls der Taster gedrückt ist, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Input__isPressed(u8 nKey);
+
+	/*!
+	 *	@function	Input__getLost
+	 *	@brief
+	 *	Gibt die Anzahl Ereignisse zurück, die wegen
+	 *	voller Warteschlange verworfen wurden.
+	 *
+	 *	@return		u16
+	 *	Anzahl verworfene Ereignisse.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u16 Input__getLost(void);
+
+#endif // !defined(JAQ_INPUT_H)
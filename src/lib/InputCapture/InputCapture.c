@@ -0,0 +1,203 @@
+/*!
+ *	@file		InputCapture.c
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#include <InputCapture/InputCapture.h>
+#include <Timer/Timer.h>	// Timer__*
+
+// Statische Definitionen --------------------------------
+#define __BUFFER_SIZE		8u
+
+// Zählerschritte pro Millisekunde (Prescaler 1)
+#define __TICKS_PER_MS		16000l
+
+static InputCapture__event_t __events[__BUFFER_SIZE];
+static volatile u8 __nHead			= 0;
+static volatile u8 __nLength		= 0;
+static volatile u16 __nLost			= 0;
+
+static bool __bStarted				= FALSE;
+
+// Zeitpunkt des Starts (Zählerstand 0)
+static InputCapture__event_t __start;
+// Statische Definitionen --------------------------------
+
+/*!
+ **********************************************************
+ * TIMER 1 INPUT CAPTURE INTERRUPT
+ **********************************************************
+ *	Wird bei jeder Flanke an ICP1 (PD6) aufgerufen.
+ *	Der Zählerstand wurde bereits von der Hardware in
+ *	ICR1 gespeichert. Danach wird auf die andere
+ *	Flanke umgeschaltet.
+ */
+ISR(TIMER1_CAPT_vect, ISR_BLOCK) {
+	u16 nCapture	= ICR1;
+	bool bRising	= BIT_ISSET(TCCR1B, ICES1);
+
+	// Auf andere Flanke umschalten, dabei wird ICF1 gesetzt
+	TCCR1B	^= _BV(ICES1);
+	// Flag wird mit 1 gelöscht, |= würde auch andere Flags löschen
+	TIFR	= _BV(ICF1);
+
+	if (__nLength == __BUFFER_SIZE) {
+		++__nLost;
+
+		return;
+	}
+
+	{
+		u8 nTail = __nHead + __nLength;
+
+		if (nTail >= __BUFFER_SIZE) {
+			nTail -= __BUFFER_SIZE;
+		}
+
+		__events[nTail].nMillis		= Timer__getTicks();
+		__events[nTail].nCapture	= nCapture;
+		__events[nTail].bRising		= bRising;
+
+		++__nLength;
+	}
+}
+
+/*!
+ *	@function	InputCapture__enable
+ */
+void InputCapture__enable(void) {
+	// Pin als Eingang konfigurieren
+	DDRD &= ~_BV(PD6);
+}
+
+/*!
+ *	@function	InputCapture__start
+ */
+void InputCapture__start(void) {
+	INTERRUPTS_REQUIRED();
+	ASSERT(__bStarted == FALSE);
+
+	// Timer/Counter1 darf nicht vom SigGen belegt sein
+	ASSERT((TCCR1B & 0b00000111) == 0);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__nHead		= 0;
+		__nLength	= 0;
+		__nLost		= 0;
+
+		// Normaler Modus
+		TCCR1A = 0;
+		TCNT1  = 0;
+
+		/*!
+		 *	Störunterdrückung aktivieren (4 Takte Verzögerung),
+		 *	erste Flanke abhängig vom aktuellen Pegel wählen.
+		 */
+		TCCR1B = _BV(ICNC1);
+
+		if (!BIT_ISSET(PIND, PD6)) {
+			TCCR1B |= _BV(ICES1);
+		}
+
+		// Input Capture Interrupt aktivieren
+		TIFR   = _BV(ICF1);
+		TIMSK |= _BV(TICIE1);
+
+		// Timer/Counter1 mit Prescaler 1 starten
+		TCCR1B |= _BV(CS10);
+
+		__start.nMillis		= Timer__getTicks();
+		__start.nCapture	= 0;
+		__start.bRising		= FALSE;
+	}
+
+	__bStarted = TRUE;
+}
+
+/*!
+ *	@function	InputCapture__getStart
+ */
+void InputCapture__getStart(InputCapture__event_t *event) {
+	ASSERT(event != NULL);
+
+	*event = __start;
+}
+
+/*!
+ *	@function	InputCapture__read
+ */
+bool InputCapture__read(InputCapture__event_t *event) {
+	bool bRead = FALSE;
+
+	ASSERT(event != NULL);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (__nLength > 0) {
+			*event = __events[__nHead];
+
+			if (++__nHead == __BUFFER_SIZE) {
+				__nHead = 0;
+			}
+
+			--__nLength;
+
+			bRead = TRUE;
+		}
+	}
+
+	return bRead;
+}
+
+/*!
+ *	@function	InputCapture__getInterval
+ */
+u32 InputCapture__getInterval(const InputCapture__event_t *first, const InputCapture__event_t *second) {
+	ASSERT(first != NULL && second != NULL);
+
+	/*!
+	 *	Der Zählerstand liefert den Abstand genau, aber nur
+	 *	modulo 65536 (4.096ms). Die Systemzeit liefert den
+	 *	Abstand auf etwa eine Millisekunde genau. Die Anzahl
+	 *	Überläufe wird so gewählt, dass beide Werte am besten
+	 *	übereinstimmen.
+	 */
+	u16 nFine	= second->nCapture - first->nCapture;
+	i32 nCoarse	= (i32)(u16)(second->nMillis - first->nMillis) * __TICKS_PER_MS;
+	i32 nWraps	= (nCoarse - (i32)nFine + 32768l) / 65536l;
+
+	if (nWraps < 0) {
+		nWraps = 0;
+	}
+
+	return (u32)nFine + ((u32)nWraps << 16ul);
+}
+
+/*!
+ *	@function	InputCapture__getLost
+ */
+u16 InputCapture__getLost(void) {
+	u16 nLost;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		nLost = __nLost;
+	}
+
+	return nLost;
+}
+
+/*!
+ *	@function	InputCapture__stop
+ */
+void InputCapture__stop(void) {
+	ASSERT(__bStarted == TRUE);
+
+	// Input Capture Interrupt deaktivieren
+	TIMSK &= ~_BV(TICIE1);
+
+	// Timer/Counter1 stoppen und freigeben
+	TCCR1B = 0;
+	TIFR   = _BV(ICF1);
+
+	__bStarted = FALSE;
+}
@@ -0,0 +1,149 @@
+/*!
+ *	@file		InputCapture.h
+ *	@brief
+ *	Dieses Modul zeichnet die Flanken des T400 Relaiskontaktes
+ *	(T400_COM an PD6/ICP1) mit der Input Capture Einheit
+ *	des Timer/Counter1 auf. Der Zählerstand wird von der
+ *	Hardware bei der Flanke gespeichert, die Latenz der ISR
+ *	spielt deshalb keine Rolle (Auflösung 62.5ns).
+ *	Die Flanken werden in einem Ringpuffer abgelegt und
+ *	können mit `InputCapture__read` abgeholt werden.
+ *
+ *	Die Zählerwerte laufen alle 4.096ms über. Zusätzlich wird
+ *	deshalb die Systemzeit in Millisekunden gespeichert,
+ *	damit `InputCapture__getInterval` auch längere Abstände
+ *	eindeutig bestimmen kann.
+ *
+ *	Beispiel:
+ *	Aufzeichnung starten:
+ *	InputCapture__start();
+ *	Flanken abholen:
+ *	while (InputCapture__read(&event)) { ... }
+ *	Abstand zweier Flanken in 62.5ns:
+ *	InputCapture__getInterval(&first, &event);
+ *	Aufzeichnung beenden:
+ *	InputCapture__stop();
+ *
+ *	@warning
+ *		- Interrupte müssen aktiviert sein!
+ *		- Der Timer/Counter1 wird während der Aufzeichnung
+ *		  belegt, der SigGen muss deaktiviert sein!
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#if !defined(JAQ_INPUTCAPTURE_H)
+	#define JAQ_INPUTCAPTURE_H 1
+
+	#include <common/common.h>
+
+	/*!
+	 *	Eine aufgezeichnete Flanke.
+	 */
+	struct InputCapture__event {
+		// Systemzeit in Millisekunden (siehe Timer__getTicks)
+		u16		nMillis;
+		// Zählerstand des Timer/Counter1 bei der Flanke (62.5ns)
+		u16		nCapture;
+		// 'TRUE' bei positiver Flanke
+		bool	bRising;
+	};
+
+	typedef		struct InputCapture__event		InputCapture__event_t;
+
+	/*!
+	 *	@function	InputCapture__enable
+	 *	@brief
+	 *	Aktiviert das InputCapture Modul.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void InputCapture__enable(void);
+
+	/*!
+	 *	@function	InputCapture__start
+	 *	@brief
+	 *	Startet den Timer/Counter1 und zeichnet ab sofort
+	 *	jede Flanke an ICP1 auf. Der Ringpuffer wird geleert.
+	 *
+	 *	@warning
+	 *		- Timer/Counter1 darf nicht laufen (siehe SigGen__disable)!
+	 *		- Timer__enable muss vorher aufgerufen worden sein!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void InputCapture__start(void);
+
+	/*!
+	 *	@function	InputCapture__getStart
+	 *	@brief
+	 *	Gibt den Start der Aufzeichnung als Flanke zurück,
+	 *	z.B. um mit `InputCapture__getInterval` die Zeit bis
+	 *	zur ersten Flanke zu bestimmen.
+	 *
+	 *	@param		event		Hier wird der Start abgelegt.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void InputCapture__getStart(InputCapture__event_t *event);
+
+	/*!
+	 *	@function	InputCapture__read
+	 *	@brief
+	 *	Holt die älteste aufgezeichnete Flanke ab.
+	 *
+	 *	@param		event		Hier wird die Flanke abgelegt.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls eine Flanke abgeholt wurde, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool InputCapture__read(InputCapture__event_t *event);
+
+	/*!
+	 *	@function	InputCapture__getInterval
+	 *	@brief
+	 *	Berechnet den Abstand zweier Flanken.
+	 *
+	 *	@param		first		Frühere Flanke.
+	 *	@param		second		Spätere Flanke.
+	 *
+	 *	@return		u32
+	 *	Abstand in Zählerschritten (62.5ns).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u32 InputCapture__getInterval(const InputCapture__event_t *first, const InputCapture__event_t *second);
+
+	/*!
+	 *	@function	InputCapture__getLost
+	 *	@brief
+	 *	Gibt die Anzahl Flanken zurück, die seit dem Start
+	 *	wegen vollem Ringpuffer verworfen wurden.
+	 *
+	 *	@return		u16
+	 *	Anzahl verworfene Flanken.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u16 InputCapture__getLost(void);
+
+	/*!
+	 *	@function	InputCapture__stop
+	 *	@brief
+	 *	Beendet die Aufzeichnung und gibt den Timer/Counter1 frei.
+	 *	Bereits aufgezeichnete Flanken bleiben im Ringpuffer.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void InputCapture__stop(void);
+
+#endif // !defined(JAQ_INPUTCAPTURE_H)
@@ -7,13 +7,110 @@
 #include <IntADC/IntADC.h>
 
 // Statische Definitionen --------------------------------
-static bool __bStarted	= FALSE;
+static bool __bStarted				= FALSE;
 
-static INLINE ldbl __toVoltage(u16 nReading) {
-	return nReading * (ldbl)4E-3L;
+// Kanalliste der aktuellen Abtastung
+static u8 __nChannels[INTADC_MAX_SCAN_CHANNELS];
+static u8 __nNumChannels			= 0;
+
+/*!
+ *	Im Free Running Modus startet die nächste Wandlung sofort.
+ *	Ein neuer Kanal in ADMUX wirkt deshalb erst für die
+ *	übernächste Wandlung.
+ *	__nConvIndex	: Kanalindex der Wandlung die gerade läuft
+ *	__nNextIndex	: Kanalindex der in ADMUX eingestellt ist
+ */
+static volatile u8 __nConvIndex		= 0;
+static volatile u8 __nNextIndex		= 0;
+
+// Anzahl noch zu verwerfende Wandlungen
+static volatile u8 __nDiscard		= 0;
+
+// Von der ISR aufsummierte Rohwerte pro Kanal
+static volatile i32 __nSum[INTADC_MAX_SCAN_CHANNELS];
+static volatile u16 __nNum[INTADC_MAX_SCAN_CHANNELS];
+static volatile u16 __nMin[INTADC_MAX_SCAN_CHANNELS];
+static volatile u16 __nMax[INTADC_MAX_SCAN_CHANNELS];
+static volatile u32 __nSquares[INTADC_MAX_SCAN_CHANNELS];
+
+/*!
+ *	Maximale Anzahl Wandlungen pro Abholung, damit die
+ *	Quadratsumme in u32 passt: 4096 * 1023² < 2³²
+ */
+#define __MAX_READINGS	4096u
+
+static INLINE void __setChannel(u8 nCH) {
+	// Löschen von Kanalselektion
+	ADMUX &= 0b11100000;
+	// Kanalselektion setzen
+	ADMUX |= nCH;
+}
+
+static void __resetReadings(void) {
+	for (u8 nI = 0; nI < INTADC_MAX_SCAN_CHANNELS; ++nI) {
+		__nSum[nI]		= 0;
+		__nNum[nI]		= 0;
+		__nSquares[nI]	= 0;
+	}
+}
+
+static void __stop(void) {
+	// Free Running Modus beenden und laufende Wandelung abwarten
+	ADCSRA &= ~(_BV(ADATE) | _BV(ADIE));
+
+	while (BIT_ISSET(ADCSRA, ADSC));
 }
 // Statische Definitionen --------------------------------
 
+/*!
+ **********************************************************
+ * ADC CONVERSION COMPLETE INTERRUPT
+ **********************************************************
+ *	Wird im Free Running Modus nach jeder Wandlung aufgerufen.
+ *	Wandlungszeit = 13 * 128 / 16MHz = 104 Mikrosekunden
+ *	Bei mehreren Kanälen wird hier auf den nächsten
+ *	Kanal umgeschaltet.
+ */
+ISR(ADC_vect, ISR_BLOCK) {
+	u16 nReading	= ADCW;
+	u8 nIndex		= __nConvIndex;
+
+	// Die bereits laufende Wandlung verwendet den eingestellten Kanal
+	__nConvIndex = __nNextIndex;
+
+	if (__nNumChannels > 1) {
+		if (++__nNextIndex == __nNumChannels) {
+			__nNextIndex = 0;
+		}
+
+		__setChannel(__nChannels[__nNextIndex]);
+	}
+
+	if (__nDiscard > 0) {
+		--__nDiscard;
+
+		return;
+	}
+
+	// Quadratsumme darf nicht überlaufen
+	if (__nNum[nIndex] == __MAX_READINGS) {
+		return;
+	}
+
+	if (__nNum[nIndex] == 0) {
+		__nMin[nIndex] = nReading;
+		__nMax[nIndex] = nReading;
+	} else if (nReading < __nMin[nIndex]) {
+		__nMin[nIndex] = nReading;
+	} else if (nReading > __nMax[nIndex]) {
+		__nMax[nIndex] = nReading;
+	}
+
+	__nSum[nIndex]		+= nReading;
+	__nSquares[nIndex]	+= (u32)nReading * nReading;
+	__nNum[nIndex]		+= 1;
+}
+
 /*!
  *	@function	IntADC__enable
  */
@@ -25,26 +122,64 @@ void IntADC__enable(void) {
 	ADCSRA |= _BV(ADEN);
 	// Samplefrequenz einstellen
 	ADCSRA |= _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+	// Free Running Modus als Auslösequelle
+	SFIOR  &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0));
 }
 
 /*!
  *	@function	IntADC__startMeasurement
  */
 void IntADC__startMeasurement(IntADC_channel_t nCH) {
+	u8 nChannel = nCH;
+
+	IntADC__startScan(&nChannel, 1);
+}
+
+/*!
+ *	@function	IntADC__startScan
+ */
+void IntADC__startScan(const u8 *nChannels, u8 nNumChannels) {
 	ASSERT(BIT_ISSET(ADCSRA, ADEN));
 	ASSERT(__bStarted == FALSE);
-	ASSERT(nCH < 8);
+	ASSERT(nChannels != NULL);
+	ASSERT(nNumChannels > 0 && nNumChannels <= INTADC_MAX_SCAN_CHANNELS);
 
-	// Löschen von Kanalselektion
-	ADMUX &= 0b11100000;
-	// Kanalselektion setzen
-	ADMUX |= nCH;
-	ADCW   = 0;
+	/*!
+	 *	Der ADC läuft nach dem ersten Start weiter.
+	 *	Nur wenn sich die Kanalliste ändert wird der ADC
+	 *	neu gestartet und die bisherigen Rohwerte verworfen.
+	 */
+	if (nNumChannels != __nNumChannels || memcmp(nChannels, __nChannels, nNumChannels) != 0 || !BIT_ISSET(ADCSRA, ADATE)) {
+		__stop();
 
-	_delay_ms(1);
+		for (u8 nI = 0; nI < nNumChannels; ++nI) {
+			ASSERT(nChannels[nI] < 8);
+
+			__nChannels[nI] = nChannels[nI];
+		}
 
-	// Wandelung starten
-	ADCSRA |= _BV(ADSC);
+		__nNumChannels	= nNumChannels;
+		__nConvIndex	= 0;
+		__nNextIndex	= 0;
+
+		__setChannel(__nChannels[0]);
+
+		__resetReadings();
+
+		/*!
+		 *	Die erste Wandlung nach dem Kanalwechsel wird
+		 *	verworfen und ersetzt die Wartezeit zum Einschwingen.
+		 *	Beim Abtasten mehrerer Kanäle wird danach bei jeder
+		 *	Wandlung umgeschaltet, die Sample and Hold Stufe
+		 *	ist bei einer Quellimpedanz unter 10kOhm innerhalb
+		 *	der Abtastzeit eingeschwungen.
+		 */
+		__nDiscard = 1;
+
+		// Free Running Modus und Interrupt aktivieren, Wandelung starten
+		ADCSRA |= _BV(ADATE) | _BV(ADIE) | _BV(ADIF);
+		ADCSRA |= _BV(ADSC);
+	}
 
 	__bStarted = TRUE;
 }
@@ -52,31 +187,69 @@ void IntADC__startMeasurement(IntADC_channel_t nCH) {
 /*!
  *	@function	IntADC__isDone
  */
-bool IntADC__isDone(ldbl *dResult) {
+bool IntADC__isDone(Measure__readings_t *readings) {
 	ASSERT(__bStarted == TRUE);
 
-	bool bIsDone	= !BIT_ISSET(ADCSRA, ADSC);
+	bool bIsDone = TRUE;
+
+	/*!
+	 *	Die in der ISR aufsummierten Rohwerte werden
+	 *	atomar übernommen und zurückgesetzt, sobald
+	 *	jeder Kanal mindestens eine Wandlung hat.
+	 */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for (u8 nI = 0; nI < __nNumChannels; ++nI) {
+			if (__nNum[nI] == 0) {
+				bIsDone = FALSE;
+			}
+		}
 
-	if (bIsDone == TRUE) {
-		if (dResult != NULL) {
-			*dResult = __toVoltage(ADCW);
+		if (bIsDone == TRUE) {
+			if (readings != NULL) {
+				for (u8 nI = 0; nI < __nNumChannels; ++nI) {
+					readings[nI].nSum		= __nSum[nI];
+					readings[nI].nNum		= __nNum[nI];
+					readings[nI].nMin		= __nMin[nI];
+					readings[nI].nMax		= __nMax[nI];
+					/*!
+					 *	Quadrate um den kleinsten Rohwert m verschieben:
+					 *	Σ(x-m)² = Σx² - m·(2Σx - n·m)
+					 *	Modulo 2³² gerechnet ist das Ergebnis exakt.
+					 */
+					readings[nI].nSquares	= __nSquares[nI] - (u32)__nMin[nI] * (2 * (u32)__nSum[nI] - (u32)__nNum[nI] * __nMin[nI]);
+				}
+			}
+
+			__resetReadings();
 		}
+	}
 
+	if (bIsDone == TRUE) {
 		__bStarted = FALSE;
 	}
 
 	return bIsDone;
 }
 
+/*!
+ *	@function	IntADC__toVoltage
+ */
+ldbl IntADC__toVoltage(ldbl dRawResult) {
+	// 1 LSB = 4mV
+	return dRawResult * 4E-3L;
+}
+
 /*!
  *	@function	IntADC__disable
  */
 void IntADC__disable(void) {
 	// Messung muss abgeschlossen sein
 	ASSERT(__bStarted == FALSE);
-	// Wandelung muss fertig sein
-	ASSERT(!BIT_ISSET(ADCSRA, ADSC));
+
+	__stop();
 
 	// ADC deaktivieren
 	ADCSRA	= 0x00;
+
+	__nNumChannels = 0;
 }
@@ -1,6 +1,11 @@
 /*!
  *	@file		IntADC.h
  *	@brief
+ *	Dieses Modul übernimmt die Ansteuerung des internen ADCs.
+ *	Der ADC läuft im Free Running Modus, die Wandlungen
+ *	werden in der ADC_vect ISR aufsummiert.
+ *	Mit `IntADC__startScan` werden mehrere Kanäle abwechselnd
+ *	gemessen, die Rohwerte werden pro Kanal aufsummiert.
  *
  *	@author		Marco Agnoli
  *	@copyright	2016 <Marco Agnoli>
@@ -11,6 +16,7 @@
 	#define JAQ_INTADC_H 1
 
 	#include <common/common.h>
+	#include <Measure/Measure.h>
 
 	enum IntADC__channelSetting {
 		IntADCCH0 = 0b000,
@@ -25,12 +31,17 @@
 
 	typedef		enum IntADC__channelSetting		IntADC_channel_t;
 
+	// Maximale Anzahl Kanäle pro Abtastung
+	#define INTADC_MAX_SCAN_CHANNELS	2u
+
 	void IntADC__enable(void);
 
 	/*!
 	 *	@function	IntADC__startMeasurement
 	 *	@brief
 	 *	Startet eine Messung mit dem internen ADC.
+	 *	Bei einem Kanalwechsel werden die ersten Wandlungen
+	 *	verworfen, ansonsten läuft der ADC ohne Unterbruch weiter.
 	 *
 	 *	@param		nCH			Kanalselektion (siehe IntADC_channel_t)
 	 *
@@ -41,16 +52,34 @@
 	 */
 	void IntADC__startMeasurement(IntADC_channel_t nCH);
 
+	/*!
+	 *	@function	IntADC__startScan
+	 *	@brief
+	 *	Startet eine Messung über mehrere Kanäle.
+	 *	Die Kanäle werden von der ISR nach jeder Wandlung
+	 *	reihum umgeschaltet.
+	 *
+	 *	@param		nChannels		Liste der Kanäle (siehe IntADC_channel_t)
+	 *	@param		nNumChannels	Anzahl Kanäle (1 bis INTADC_MAX_SCAN_CHANNELS)
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void IntADC__startScan(const u8 *nChannels, u8 nNumChannels);
+
 	/*!
 	 *	@function	IntADC__isDone
 	 *	@brief
-	 *	Prüft ob der interne ADC mit der Messung fertig ist.
+	 *	Prüft ob der interne ADC seit dem letzten Aufruf
+	 *	Wandlungen abgeschlossen hat.
 	 *
-	 *	@param		dResult		Wenn dResult nicht 'NULL' ist, wird das
-	 *	Ergebnis dort abgelegt. (Einheit: V)
+	 *	@param		readings	Wenn readings nicht 'NULL' ist, werden die
+	 *	aufsummierten Rohwerte dort abgelegt, ein Eintrag pro Kanal
+	 *	in der Reihenfolge der Kanalliste. (Einheit: LSB, siehe IntADC__toVoltage)
 	 *
 	 *	@return
-	 *	'TRUE' wenn Messung fertig, ansonsten 'FALSE'.
+	 *	'TRUE' wenn für jeden Kanal mindestens eine Wandlung
+	 *	fertig ist, ansonsten 'FALSE'.
 	 *
 	 *	@warning
 	 *		- IntADC__startMeasurement muss vorher aufgerufen worden sein!
@@ -60,7 +89,22 @@
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	bool IntADC__isDone(ldbl *dResult);
+	bool IntADC__isDone(Measure__readings_t *readings);
+
+	/*!
+	 *	@function	IntADC__toVoltage
+	 *	@brief
+	 *	Rechnet einen (gemittelten) Rohwert in eine Spannung um.
+	 *
+	 *	@param		dRawResult	Rohwert in LSB.
+	 *
+	 *	@return		ldbl
+	 *	Spannung in V.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	ldbl IntADC__toVoltage(ldbl dRawResult);
 
 	/*!
 	 *	@function	IntADC__disable
@@ -6,10 +6,151 @@
  */
 #include <LCD/LCD.h>
 #include <LCD/_lcd.h>	// lcd_*
+#include <Timer/Timer.h>	// Timer__*
 #include <stdarg.h>		// va_list
 
 // Statische Definitionen --------------------------------
+#define __LINES			LCD_LINES
+#define __COLUMNS		LCD_DISP_LENGTH
+
+/*!
+ *	Buszyklen eines kompletten Neuaufbaus:
+ *	Löschen, alle Zeichen und die Zeilenwechsel.
+ */
+#define __FULL_REDRAW	(1u + __LINES * __COLUMNS + (__LINES - 1u))
+
 static bool __bInited	= FALSE;
+
+// Soll-Inhalt, wird von LCD__print usw. beschrieben
+static u8 __cFrame[__LINES][__COLUMNS];
+// Ist-Inhalt des LC-Displays
+static u8 __cShadow[__LINES][__COLUMNS];
+
+// Cursor im Soll-Inhalt
+static u8 __nX			= 0;
+static u8 __nY			= 0;
+
+static u32 __nSavedCycles	= 0;
+
+/*!
+ *	Warteschlange für Befehls- und Datenbytes.
+ *	Sie wird vom Timer im Millisekundentakt geleert,
+ *	ein Byte (ein Nibble-Paar) pro Aufruf. Die meisten
+ *	Befehle brauchen höchstens 40us, das Busy-Flag wird
+ *	deshalb in der ISR nie gelesen. Langsame Befehle
+ *	werden über `__nHoldTicks` abgewartet.
+ *	Ein Neuaufbau (34 Bytes) passt nicht ganz hinein,
+ *	__send wartet dann bis der Timer Platz geschaffen hat.
+ */
+#define __QUEUE_SIZE	24u
+
+static u8 __nQueueBytes[__QUEUE_SIZE];
+// Bit n gesetzt: Eintrag n ist ein Datenbyte, ansonsten ein Befehl
+static u8 __nQueueData[(__QUEUE_SIZE + 7u) / 8u];
+static volatile u8 __nQueueHead		= 0;
+static volatile u8 __nQueueLength	= 0;
+
+// Verbleibende Ticks nach Clear/Home (1.52ms)
+static u8 __nHoldTicks				= 0;
+
+static bool __bQueueEnabled			= FALSE;
+
+#define __IS_DATA(_index)	BIT_ISSET(__nQueueData[(_index) >> 3], (_index) & 7u)
+
+static const u8 __nLineStart[__LINES] PROGMEM = {LCD_START_LINE1, LCD_START_LINE2};
+
+/*!
+ *	Wird jede Millisekunde vom Timer (ISR) aufgerufen und
+ *	überträgt das älteste Byte der Warteschlange.
+ */
+static void __drain(Timer__ID_t nTimer) {
+	if (__nHoldTicks > 0) {
+		--__nHoldTicks;
+
+		return;
+	}
+
+	if (__nQueueLength == 0) return;
+
+	{
+		u8 nByte	= __nQueueBytes[__nQueueHead];
+		bool bData	= __IS_DATA(__nQueueHead);
+
+		lcd_send(nByte, bData);
+
+		// Clear und Home dauern länger als ein Tick
+		if (bData == FALSE && nByte < (1 << LCD_ENTRY_MODE)) {
+			__nHoldTicks = 1;
+		}
+	}
+
+	if (++__nQueueHead == __QUEUE_SIZE) {
+		__nQueueHead = 0;
+	}
+
+	--__nQueueLength;
+}
+
+/*!
+ *	Überträgt die Warteschlange ohne Timer.
+ *	Wird verwendet falls Interrupte deaktiviert sind.
+ */
+static void __flush(void) {
+	while (__nQueueLength > 0) {
+		if (__IS_DATA(__nQueueHead)) {
+			lcd_data(__nQueueBytes[__nQueueHead]);
+		} else {
+			lcd_command(__nQueueBytes[__nQueueHead]);
+		}
+
+		if (++__nQueueHead == __QUEUE_SIZE) {
+			__nQueueHead = 0;
+		}
+
+		--__nQueueLength;
+	}
+
+	__nHoldTicks = 0;
+}
+
+/*!
+ *	Gibt ein Byte an das LC-Display aus. Mit aktivierter
+ *	Warteschlange wird es nur eingereiht, ansonsten direkt
+ *	(mit Abfrage des Busy-Flags) geschrieben.
+ */
+static void __send(u8 nByte, bool bData) {
+	if (__bQueueEnabled && BIT_ISSET(SREG, 7)) {
+		// Warten bis der Timer Platz geschaffen hat
+		while (__nQueueLength == __QUEUE_SIZE);
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			u8 nTail = __nQueueHead + __nQueueLength;
+
+			if (nTail >= __QUEUE_SIZE) {
+				nTail -= __QUEUE_SIZE;
+			}
+
+			__nQueueBytes[nTail] = nByte;
+
+			if (bData) {
+				__nQueueData[nTail >> 3] |= _BV(nTail & 7u);
+			} else {
+				__nQueueData[nTail >> 3] &= ~_BV(nTail & 7u);
+			}
+
+			++__nQueueLength;
+		}
+	} else {
+		// Reihenfolge einhalten
+		__flush();
+
+		if (bData) {
+			lcd_data(nByte);
+		} else {
+			lcd_command(nByte);
+		}
+	}
+}
 // Statische Definitionen --------------------------------
 
 /*!
@@ -19,26 +160,31 @@ void LCD__init(void) {
 	if (__bInited == FALSE) {
 		lcd_init(LCD_DISP_ON);
 
+		// Das Display ist nach der Initialisierung leer
+		memset(__cShadow, ' ', sizeof(__cShadow));
+		LCD__clearScreen();
+
 		__bInited = TRUE;
 	}
 }
 
 /*!
- *	@function	LCD__init
+ *	@function	LCD__clearScreen
  */
 void LCD__clearScreen(void) {
-	lcd_clrscr();
+	memset(__cFrame, ' ', sizeof(__cFrame));
+
+	__nX = 0;
+	__nY = 0;
 }
 
 /*!
  *	@function	LCD__clearLine
  */
 void LCD__clearLine(u8 nY) {
-	LCD__gotoXY(0, nY);
+	if (nY >= __LINES) return;
 
-	for (u8 nI = 0; nI < 16; ++nI) {
-		LCD__putc(' ');
-	}
+	memset(__cFrame[nY], ' ', __COLUMNS);
 
 	LCD__gotoXY(0, nY);
 }
@@ -47,7 +193,8 @@ void LCD__clearLine(u8 nY) {
  *	@function	LCD__gotoXY
  */
 void LCD__gotoXY(u8 nX, u8 nY) {
-	lcd_gotoxy(nX, nY);
+	__nX = nX;
+	__nY = (nY < __LINES ? nY : __LINES - 1);
 }
 
 /*!
@@ -67,17 +214,185 @@ void LCD__print(const char *sStr, ...) {
 
 	if (nNum <= 0) return;
 
-	lcd_puts(cBuffer);
-	
-	/*
-	for (int i = 0; i < nNum; ++i) {
-		lcd_putc(cBuffer[i]);
-	}*/
+	LCD__puts(cBuffer);
+}
+
+/*!
+ *	@function	LCD__print_P
+ */
+void LCD__print_P(const char *sStr, ...) {
+	char cBuffer[32];
+	int nNum;
+
+	if (!sStr) return;
+
+	va_list ap;
+
+	va_start(ap, sStr);
+	nNum = vsnprintf_P(cBuffer, sizeof(cBuffer), sStr, ap);
+	va_end(ap);
+
+	if (nNum <= 0) return;
+
+	LCD__puts(cBuffer);
+}
+
+/*!
+ *	@function	LCD__puts
+ */
+void LCD__puts(const char *sStr) {
+	if (!sStr) return;
+
+	while (*sStr) {
+		LCD__putc(*sStr++);
+	}
+}
+
+/*!
+ *	@function	LCD__puts_P
+ */
+void LCD__puts_P(const char *sStr) {
+	char cChar;
+
+	if (!sStr) return;
+
+	while ((cChar = pgm_read_byte(sStr++)) != 0) {
+		LCD__putc(cChar);
+	}
 }
 
 /*!
  *	@function	LCD__putc
  */
 void LCD__putc(u8 cChar) {
-	lcd_putc(cChar);
+	if (cChar == '\n') {
+		// Wie lcd_putc: von der letzten Zeile zurück zur ersten
+		if (++__nY == __LINES) {
+			__nY = 0;
+		}
+
+		__nX = 0;
+	} else if (__nX < __COLUMNS) {
+		// Zeichen ausserhalb der sichtbaren Zeile werden verworfen
+		__cFrame[__nY][__nX++] = cChar;
+	}
+}
+
+/*!
+ *	@function	LCD__update
+ */
+void LCD__update(void) {
+	u8 nCycles = 0;
+
+	for (u8 nY = 0; nY < __LINES; ++nY) {
+		// Adresszähler des Displays steht auf der aktuellen Zelle
+		bool bCursor = FALSE;
+
+		for (u8 nX = 0; nX < __COLUMNS; ++nX) {
+			u8 cChar = __cFrame[nY][nX];
+
+			if (__cShadow[nY][nX] == cChar) {
+				bCursor = FALSE;
+
+				continue;
+			}
+
+			/*!
+			 *	Der Adresszähler wird nach jedem Zeichen erhöht,
+			 *	nur nach übersprungenen Zellen muss er neu
+			 *	gesetzt werden.
+			 */
+			if (bCursor == FALSE) {
+				__send(_BV(LCD_DDRAM) | (pgm_read_byte(&__nLineStart[nY]) + nX), FALSE);
+
+				++nCycles;
+				bCursor = TRUE;
+			}
+
+			__send(cChar, TRUE);
+			__cShadow[nY][nX] = cChar;
+
+			++nCycles;
+		}
+	}
+
+	__nSavedCycles += __FULL_REDRAW - nCycles;
+}
+
+/*!
+ *	@function	LCD__defineGlyph
+ */
+void LCD__defineGlyph(u8 nCode, const u8 *nRows) {
+	if (nCode >= LCD_GLYPHS || !nRows) return;
+
+	// Danach steht der Adresszähler im CGRAM, LCD__update setzt ihn neu
+	__send(_BV(LCD_CGRAM) | (nCode << 3), FALSE);
+
+	for (u8 nI = 0; nI < 8; ++nI) {
+		__send(nRows[nI] & 0x1F, TRUE);
+	}
+}
+
+/*!
+ *	@function	LCD__enableQueue
+ */
+void LCD__enableQueue(void) {
+	Timer__ID_t nTimer;
+
+	if (__bQueueEnabled) return;
+
+	nTimer = Timer__create();
+
+	Timer__setCallback(nTimer, __drain);
+	Timer__startPeriodic(nTimer, 1);
+
+	__bQueueEnabled = TRUE;
+}
+
+/*!
+ *	@function	LCD__isIdle
+ */
+bool LCD__isIdle(void) {
+	return __nQueueLength == 0;
+}
+
+/*!
+ *	@function	LCD__getSavedCycles
+ */
+u32 LCD__getSavedCycles(void) {
+	return __nSavedCycles;
+}
+
+#if defined(LCD_BENCHMARK)
+/*!
+ *	@function	LCD__benchmark
+ */
+u16 LCD__benchmark(u8 nCount) {
+	u32 nCycles = 0;
+
+	ASSERT(__bInited == TRUE && nCount > 0);
+
+	__flush();
+
+	lcd_command(_BV(LCD_DDRAM) | (LCD_START_LINE1 + __COLUMNS));
+
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);
+
+	for (u8 nI = 0; nI < nCount; ++nI) {
+		while (lcd_busy());
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			u16 nStart = TCNT1;
+
+			lcd_data(nI);
+
+			nCycles += (u16)(TCNT1 - nStart);
+		}
+	}
+
+	TCCR1B = 0;
+
+	return nCycles / nCount;
 }
+#endif
@@ -1,6 +1,18 @@
 /*!
  *	@file		LCD.h
  *	@brief
+ *	Ansteuerung des 2x16 LC-Displays über einen Bildspeicher.
+ *	LCD__print, LCD__putc usw. schreiben nur in den Bildspeicher
+ *	im RAM. Erst LCD__update überträgt die Zellen, die sich seit
+ *	der letzten Übertragung geändert haben. Das Löschen des
+ *	Displays (1.52ms) und das erneute Schreiben unveränderter
+ *	Zeichen entfallen.
+ *
+ *	Nach LCD__enableQueue werden die Bytes nicht mehr direkt
+ *	geschrieben, sondern in eine Warteschlange eingereiht, die
+ *	vom Timer im Millisekundentakt geleert wird. LCD__update
+ *	kehrt dann sofort zurück, statt für jedes Zeichen auf das
+ *	Busy-Flag zu warten.
  *
  *	@author		Marco Agnoli
  *	@copyright	2016 <Marco Agnoli>
@@ -12,6 +24,9 @@
 
 	#include <common/common.h>
 
+	// Anzahl frei definierbarer Zeichen (Code 0 bis 7)
+	#define LCD_GLYPHS		8u
+
 	/*!
 	 *	@function	LCD__init
 	 *	@brief
@@ -27,7 +42,8 @@
 	/*!
 	 *	@function	LCD__clearScreen
 	 *	@brief
-	 *	Löscht den gesamten Inhalt auf dem LC-Display.
+	 *	Löscht den gesamten Inhalt auf dem LC-Display
+	 *	und setzt den Cursor auf den Anfang.
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
@@ -80,6 +96,47 @@
 	 */
 	UNUSED void LCD__print(const char *sStr, ...) FORMAT(1, 2);
 
+	/*!
+	 *	@function	LCD__print_P
+	 *	@brief
+	 *	Wie LCD__print, `sStr` liegt aber im Flash (PSTR).
+	 *
+	 *	@param		sStr
+	 *	Zeichenkette im Flash die ausgegeben werden soll.
+	 *	@param		...
+	 *	Allfällige Variablen.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED void LCD__print_P(const char *sStr, ...);
+
+	/*!
+	 *	@function	LCD__puts
+	 *	@brief
+	 *	Gibt `sStr` ohne Formatierung am LC-Display aus.
+	 *
+	 *	@param		sStr
+	 *	Zeichenkette die ausgegeben werden soll.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED void LCD__puts(const char *sStr);
+
+	/*!
+	 *	@function	LCD__puts_P
+	 *	@brief
+	 *	Wie LCD__puts, `sStr` liegt aber im Flash (PSTR).
+	 *
+	 *	@param		sStr
+	 *	Zeichenkette im Flash die ausgegeben werden soll.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED void LCD__puts_P(const char *sStr);
+
 	/*!
 	 *	@function	LCD__putc
 	 *	@brief
@@ -96,4 +153,110 @@
 	 */
 	UNUSED void LCD__putc(u8 cChar);
 
+	/*!
+	 *	@function	LCD__update
+	 *	@brief
+	 *	Überträgt den Bildspeicher auf das LC-Display.
+	 *	Es werden nur geänderte Zellen geschrieben, der
+	 *	Adresszähler wird nur nach übersprungenen Zellen
+	 *	neu gesetzt.
+	 *	Mit aktivierter Warteschlange blockiert die Funktion
+	 *	nur, falls die Warteschlange voll ist.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED void LCD__update(void);
+
+	/*!
+	 *	@function	LCD__defineGlyph
+	 *	@brief
+	 *	Definiert das Zeichen `nCode` im CGRAM des LC-Displays.
+	 *	Zellen mit diesem Code ändern ihr Aussehen sofort,
+	 *	ohne dass sie neu geschrieben werden müssen.
+	 *
+	 *	@param		nCode
+	 *	Zeichencode (0 bis LCD_GLYPHS - 1).
+	 *	@param		nRows
+	 *	Acht Zeilen zu je fünf Bit (Bit 4 ist die linke Spalte).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED void LCD__defineGlyph(u8 nCode, const u8 *nRows);
+
+	/*!
+	 *	@function	LCD__enableQueue
+	 *	@brief
+	 *	Aktiviert die Warteschlange. Ab sofort überträgt
+	 *	ein Timer jede Millisekunde ein Byte an das LC-Display.
+	 *	Bei deaktivierten Interrupten (z.B. PANIC) wird weiterhin
+	 *	direkt geschrieben.
+	 *
+	 *	@warning
+	 *		- Timer__enable muss vorher aufgerufen worden sein!
+	 *		- PORTB und PORTC dürfen danach nur noch atomar
+	 *		  verändert werden (Datenleitungen des LC-Displays).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED void LCD__enableQueue(void);
+
+	/*!
+	 *	@function	LCD__isIdle
+	 *	@brief
+	 *	Prüft ob alle Bytes an das LC-Display übertragen wurden.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls die Warteschlange leer ist, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED bool LCD__isIdle(void);
+
+	/*!
+	 *	@function	LCD__getSavedCycles
+	 *	@brief
+	 *	Gibt die Anzahl Buszyklen (Befehls- oder Datenbytes)
+	 *	zurück, die LCD__update gegenüber einem kompletten
+	 *	Neuaufbau (Löschen und alle Zeichen schreiben)
+	 *	eingespart hat.
+	 *
+	 *	@return		u32
+	 *	Eingesparte Buszyklen seit dem Start.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	UNUSED u32 LCD__getSavedCycles(void);
+
+	#if defined(LCD_BENCHMARK)
+	/*!
+	 *	@function	LCD__benchmark
+	 *	@brief
+	 *	Misst mit Timer1 (ohne Vorteiler) die CPU-Takte von
+	 *	`nCount` Aufrufen von lcd_data. Vor jeder Messung wird
+	 *	gewartet bis das Display bereit ist, gemessen wird also
+	 *	nur die Ausgabe am Port und nicht die Ausführungszeit
+	 *	des Displays. Die Bytes landen in unsichtbaren Zellen
+	 *	hinter der ersten Zeile.
+	 *	Mit `make benchmark LCD_DATA_LUT=0` bzw. `=1` bauen.
+	 *
+	 *	@param		nCount		Anzahl Aufrufe (min. 1).
+	 *
+	 *	@return		u16
+	 *	Mittlere Takte pro Aufruf.
+	 *
+	 *	@warning
+	 *		- Benutzt Timer1, muss vor SigGen__enable aufgerufen
+	 *		  werden.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u16 LCD__benchmark(u8 nCount);
+	#endif
+
 #endif // !defined(JAQ_LCD_H)
@@ -77,6 +77,41 @@
 #endif
 #endif
 
+#if LCD_IO_MODE && LCD_DATA_LUT
+/*
+ * Data lines which are not on bit 0..3 of one port (e.g. PC4, PC3, PC2, PB0).
+ * Port P is the port of data bit 0. The compiler builds a table in flash
+ * from the pin map: entry n holds the bits of port P to set for nibble n,
+ * so all lines on port P are written with one lpm and one masked store.
+ * A line on another port is still set or cleared on its own: a bit test
+ * plus sbi/cbi takes 5..6 cycles, a masked store of a single bit needs
+ * in/andi/or/out plus shifting the bit into place and is slower.
+ * All port comparisons are resolved at compile time.
+ */
+#define LCD_ON_P(port)  ( &(port) == &LCD_DATA0_PORT )
+
+#define LCD_NIBBLE_MASK(n) ( \
+	                           (((n) & 0x01) ? _BV(LCD_DATA0_PIN) : 0) | \
+	((LCD_ON_P(LCD_DATA1_PORT) && ((n) & 0x02)) ? _BV(LCD_DATA1_PIN) : 0) | \
+	((LCD_ON_P(LCD_DATA2_PORT) && ((n) & 0x04)) ? _BV(LCD_DATA2_PIN) : 0) | \
+	((LCD_ON_P(LCD_DATA3_PORT) && ((n) & 0x08)) ? _BV(LCD_DATA3_PIN) : 0) )
+
+#define LCD_MASK_P      LCD_NIBBLE_MASK(0x0F)
+
+/* line on another port than P: set/clear individually */
+#define lcd_line_out(port, pin, set) \
+	if ( !LCD_ON_P(port) ) { if (set) port |= _BV(pin); else port &= ~_BV(pin); }
+#define lcd_line_ddr(port, pin, out) \
+	if ( !LCD_ON_P(port) ) { if (out) DDR(port) |= _BV(pin); else DDR(port) &= ~_BV(pin); }
+
+static const uint8_t lcd_nibble_p[16] PROGMEM = {
+	LCD_NIBBLE_MASK(0x0), LCD_NIBBLE_MASK(0x1), LCD_NIBBLE_MASK(0x2), LCD_NIBBLE_MASK(0x3),
+	LCD_NIBBLE_MASK(0x4), LCD_NIBBLE_MASK(0x5), LCD_NIBBLE_MASK(0x6), LCD_NIBBLE_MASK(0x7),
+	LCD_NIBBLE_MASK(0x8), LCD_NIBBLE_MASK(0x9), LCD_NIBBLE_MASK(0xA), LCD_NIBBLE_MASK(0xB),
+	LCD_NIBBLE_MASK(0xC), LCD_NIBBLE_MASK(0xD), LCD_NIBBLE_MASK(0xE), LCD_NIBBLE_MASK(0xF)
+};
+#endif
+
 /*
  ** function prototypes
  */
@@ -107,6 +142,37 @@ static void toggle_e(void)
 #endif
 
 
+#if LCD_IO_MODE && LCD_DATA_LUT
+/*************************************************************************
+ Configure data lines as output (1) or input (0)
+ *************************************************************************/
+static inline void lcd_data_ddr(uint8_t out)
+{
+	if (out)
+		DDR(LCD_DATA0_PORT) |= LCD_MASK_P;
+	else
+		DDR(LCD_DATA0_PORT) &= (uint8_t)~LCD_MASK_P;
+	lcd_line_ddr(LCD_DATA1_PORT, LCD_DATA1_PIN, out);
+	lcd_line_ddr(LCD_DATA2_PORT, LCD_DATA2_PIN, out);
+	lcd_line_ddr(LCD_DATA3_PORT, LCD_DATA3_PIN, out);
+}
+
+
+/*************************************************************************
+ Output nibble on the data lines
+ Input:    nibble 0..15
+ Returns:  none
+ *************************************************************************/
+static inline void lcd_out_nibble(uint8_t nibble)
+{
+	LCD_DATA0_PORT = (LCD_DATA0_PORT & (uint8_t)~LCD_MASK_P) | pgm_read_byte(&lcd_nibble_p[nibble]);
+	lcd_line_out(LCD_DATA1_PORT, LCD_DATA1_PIN, nibble & 0x02);
+	lcd_line_out(LCD_DATA2_PORT, LCD_DATA2_PIN, nibble & 0x04);
+	lcd_line_out(LCD_DATA3_PORT, LCD_DATA3_PIN, nibble & 0x08);
+}
+#endif
+
+
 /*************************************************************************
  Low-level function to write byte to LCD controller
  Input:    data   byte to write to LCD
@@ -145,6 +211,27 @@ static void lcd_write(uint8_t data,uint8_t rs)
 		/* all data pins high (inactive) */
 		LCD_DATA0_PORT = dataBits | 0x0F;
 	}
+#if LCD_DATA_LUT
+	else
+	{
+		/* configure data pins as output */
+		lcd_data_ddr(1);
+
+		/* output high nibble first */
+		lcd_out_nibble(data >> 4);
+		lcd_e_toggle();
+
+		/* output low nibble */
+		lcd_out_nibble(data & 0x0F);
+		lcd_e_toggle();
+
+		/* all data pins high (inactive) */
+		LCD_DATA0_PORT |= LCD_MASK_P;
+		lcd_line_out(LCD_DATA1_PORT, LCD_DATA1_PIN, 1);
+		lcd_line_out(LCD_DATA2_PORT, LCD_DATA2_PIN, 1);
+		lcd_line_out(LCD_DATA3_PORT, LCD_DATA3_PIN, 1);
+	}
+#else
 	else
 	{
 		/* configure data pins as output */
@@ -181,6 +268,7 @@ static void lcd_write(uint8_t data,uint8_t rs)
 		LCD_DATA2_PORT |= _BV(LCD_DATA2_PIN);
 		LCD_DATA3_PORT |= _BV(LCD_DATA3_PIN);
 	}
+#endif
 }
 #else
 #define lcd_write(d,rs) if (rs) *(volatile uint8_t*)(LCD_IO_DATA) = d; else *(volatile uint8_t*)(LCD_IO_FUNCTION) = d;
@@ -227,10 +315,14 @@ static uint8_t lcd_read(uint8_t rs)
 	else
 	{
 		/* configure data pins as input */
+#if LCD_DATA_LUT
+		lcd_data_ddr(0);
+#else
 		DDR(LCD_DATA0_PORT) &= ~_BV(LCD_DATA0_PIN);
 		DDR(LCD_DATA1_PORT) &= ~_BV(LCD_DATA1_PIN);
 		DDR(LCD_DATA2_PORT) &= ~_BV(LCD_DATA2_PIN);
 		DDR(LCD_DATA3_PORT) &= ~_BV(LCD_DATA3_PIN);
+#endif
 
 		/* read high nibble first */
 		lcd_e_high();
@@ -354,6 +446,30 @@ void lcd_data(uint8_t data)
 }
 
 
+/*************************************************************************
+ Read busy flag without waiting
+ Input:   none
+ Returns: nonzero while the LCD controller is busy
+ *************************************************************************/
+uint8_t lcd_busy(void)
+{
+	return lcd_read(0) & (1<<LCD_BUSY);
+}
+
+
+/*************************************************************************
+ Send byte to LCD controller without reading the busy flag
+ Input:   byte to send to LCD controller
+          rs     1: write data
+                 0: write instruction
+ Returns: none
+ *************************************************************************/
+void lcd_send(uint8_t data, uint8_t rs)
+{
+	lcd_write(data,rs);
+}
+
+
 
 /*************************************************************************
  Set cursor to specified position
@@ -166,6 +166,9 @@
 #ifndef LCD_E_PIN
 #define LCD_E_PIN        5            /**< pin  for Enable line     */
 #endif
+#ifndef LCD_DATA_LUT
+#define LCD_DATA_LUT     1            /**< 1: write data lines on the port of bit 0 with a flash table and one masked store, 0: one sbi/cbi per line */
+#endif
 
 #elif defined(__AVR_AT90S4414__) || defined(__AVR_AT90S8515__) || defined(__AVR_ATmega64__) || \
 defined(__AVR_ATmega8515__)|| defined(__AVR_ATmega103__) || defined(__AVR_ATmega128__) || \
@@ -353,6 +356,29 @@ extern void lcd_command(uint8_t cmd);
 extern void lcd_data(uint8_t data);
 
 
+/**
+ @brief    Read busy flag without waiting
+
+ Reads the flag once and returns immediately. Do not poll it from
+ an interrupt, every read takes a few microseconds.
+ @param    void
+ @return   nonzero while the LCD controller is busy
+ */
+extern uint8_t lcd_busy(void);
+
+
+/**
+ @brief    Send byte to LCD controller without reading the busy flag
+
+ The caller has to make sure the previous instruction has finished,
+ e.g. by calling this function from a periodic timer interrupt.
+ @param    data byte to send to LCD controller
+ @param    rs 1: data, 0: instruction
+ @return   none
+ */
+extern void lcd_send(uint8_t data, uint8_t rs);
+
+
 /**
  @brief macros for automatically storing string constant in program memory
  */
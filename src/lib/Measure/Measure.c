@@ -20,42 +20,326 @@ struct __acquisition {
 	void								*startMeasurementFNCCTX;
 	// Funktion zum Abfragen ob die Messung fertig ist
 	Measure__isDoneFNC_t				isDoneFNC;
+	// Funktion zum Umrechnen des Rohwertes (optional)
+	Measure__toValueFNC_t				toValueFNC;
 	// Funktion zum Umwandeln des Wertes (optional)
 	Measure__cnvResultFNC_t				cnvResultFNC;
 
 	// Flag ob Messung gestartet wurde
 	bool								__bStarted;
-	// Aktueller Messwert
+	// Messwert der letzten Zeitperiode (umgerechnet mit toValueFNC)
 	ldbl								__dReading;
-	// Messwerte aufsummiert
-	ldbl								__dReadings;
-	// Anzahl gemessene Messwerte während Zeitperiode
-	u16									__nReadings;
+	// Rohwerte aufsummiert
+	i32									__nReadings;
+	// Anzahl gemessene Rohwerte während Zeitperiode
+	u16									__nNumReadings;
+	// Flag ob die Summe während der Zeitperiode begrenzt wurde
+	bool								__bSaturated;
+	// Kennungszähler beim Start der Zeitperiode
+	u8									__nTagSequence;
+	// Kennung der letzten Zeitperiode und ob sie gültig ist
+	u32									__nLastTag;
+	bool								__bLastTagValid;
+	// Index der Statistik (siehe Measure__enableStatistics)
+	u8									nStatistics;
 	// Flag ob Messung zwingend beendet werden muss
 	bool								bMustFinish;
 	// Internes Flag
 	bool								bShouldFinish;
 	// Zeitperiode in der die Messung gemacht wird
-	u8									nTimeSlice;
+	u16									nTimeSlice;
+	// Zeitgeber für die Zeitperiode
+	Timer__ID_t							nTimerID;
+	// Verwendete Peripherie
+	Measure__resource_t					nResource;
+	// Anzahl Kanäle welche die Messaufgabe liefert
+	u8									nChannels;
+	// Flag ob es sich um einen zusätzlichen Kanal einer Messaufgabe handelt
+	bool								bIsChannel;
+	// Messaufgabe und Index des Kanals (nur bei bIsChannel)
+	Measure__MeasurementID_t			nParentID;
+	u8									nChannel;
+};
+
+/*!
+ *	Statistik einer Messaufgabe, wird nur für Messaufgaben
+ *	mitgeführt welche sie mit Measure__enableStatistics
+ *	angefordert haben.
+ */
+struct __statistics {
+	// Kleinster und grösster Rohwert während Zeitperiode
+	i32									__nMin;
+	i32									__nMax;
+	// Verschiebung der Rohwerte für die Varianz
+	i32									__nShift;
+	// Quadrate der verschobenen Rohwerte aufsummiert
+	u32									__nSquares;
+	// Mittelwert, Anzahl, Extremwerte und Varianz der Rohwerte der letzten Zeitperiode
+	ldbl								__dLastMean;
+	u16									__nLastNumReadings;
+	i32									__nLastMin;
+	i32									__nLastMax;
+	ldbl								__dLastVariance;
 };
 
 typedef struct __acquisition __acquisition_t;
+typedef struct __statistics __statistics_t;
 typedef Measure__MeasurementID_t __id_t;
 
-#define __MAX_ACQUISITIONS	6u
+// measurements.c: drei Messaufgaben und ein Kanal
+#define __MAX_ACQUISITIONS	4u
+#define __MAX_RESOURCES		3u
 
-// ID für die aktuelle Messung
-static __id_t __nAcquisitionID		= 0u;
+// ID für die aktuelle Messung pro Peripherie
+static __id_t __nAcquisitionID[__MAX_RESOURCES];
 static __id_t __nAcquisitionLastID	= 0u;
 
-static ldbl __dResults[__MAX_ACQUISITIONS];
+// Flag ob Peripherie von einer Messaufgabe verwendet wird
+static bool __bResourceUsed[__MAX_RESOURCES];
+// Flag ob Zeitfenster der Peripherie gestartet wurde
+static bool __bResourceStarted[__MAX_RESOURCES];
+
 static __acquisition_t __acquisitions[__MAX_ACQUISITIONS];
 
-static bool __bTaskStarted = FALSE;
 static bool __bTaskStatus[__MAX_ACQUISITIONS];
 
-static bool __doMeasurement(__id_t nID, ldbl *dReading) {
-	ldbl dResult					= NAN;
+// Messaufgabe ohne Statistik
+#define __NO_STATISTICS		0xFFu
+
+// Quadratsumme ist übergelaufen
+#define __SQUARES_OVERFLOW	0xFFFFFFFFul
+
+static __statistics_t __statistics[MEASURE_MAX_STATISTICS];
+static u8 __nStatisticsLastID		= 0u;
+
+/*!
+ *	Kennung der aktuellen Messbedingungen (z.B. Frequenz des SigGen).
+ *	Der Zähler wird bei jeder Änderung erhöht, damit erkannt wird
+ *	ob sich die Kennung während einer Zeitperiode geändert hat.
+ */
+static volatile u32 __nTag			= 0;
+static volatile u8 __nTagSequence	= 0;
+
+/*!
+ *	Merkt sich den Kennungszähler beim Start der Zeitperiode
+ *	für die Messaufgabe `nID` und ihre Kanäle.
+ *	Die Kennung selbst muss nicht gespeichert werden: ist der
+ *	Zähler am Ende unverändert, gilt noch dieselbe Kennung.
+ */
+static void __startWindow(__id_t nID) {
+	for (__id_t nI = 0; nI < __nAcquisitionLastID; ++nI) {
+		__acquisition_t *acquisition = &__acquisitions[nI];
+
+		if (nI != nID && (acquisition->bIsChannel == FALSE || acquisition->nParentID != nID)) continue;
+
+		acquisition->__nTagSequence = __nTagSequence;
+	}
+}
+
+/*!
+ *	Nimmt die Rohwerte eines Treibers in die Statistik
+ *	der Zeitperiode auf.
+ *	Damit keine Messwerte gespeichert werden müssen und
+ *	alles ganzzahlig bleibt, werden die Quadrate um den
+ *	Mittelwert der ersten Rohwerte verschoben aufsummiert.
+ *	Der Treiber liefert die Quadrate um seinen kleinsten
+ *	Rohwert m verschoben, mit d = m - K gilt:
+ *	Σ(x-K)² = Σ(x-m)² + 2d·Σ(x-m) + n·d²
+ *	Modulo 2³² ist das Ergebnis exakt, solange die Summe
+ *	in u32 passt. Das wird vorher über die grösste
+ *	Abweichung abgeschätzt, sonst bleibt die Summe auf
+ *	__SQUARES_OVERFLOW stehen.
+ */
+static void __addStatistics(__statistics_t *statistics, bool bFirst, const Measure__readings_t *readings) {
+	i32 nShift;
+	i32 nDelta;
+	u32 nSpan;
+
+	if (bFirst == TRUE) {
+		statistics->__nShift	= readings->nSum / readings->nNum;
+		statistics->__nMin		= readings->nMin;
+		statistics->__nMax		= readings->nMax;
+		statistics->__nSquares	= 0;
+	} else {
+		if (readings->nMin < statistics->__nMin) {
+			statistics->__nMin	= readings->nMin;
+		}
+
+		if (readings->nMax > statistics->__nMax) {
+			statistics->__nMax	= readings->nMax;
+		}
+	}
+
+	if (statistics->__nSquares == __SQUARES_OVERFLOW) {
+		return;
+	}
+
+	nShift	= statistics->__nShift;
+	nDelta	= readings->nMin - nShift;
+
+	// Grösste Abweichung eines Rohwertes von der Verschiebung
+	if (readings->nMax - nShift > nShift - readings->nMin) {
+		nSpan = readings->nMax - nShift;
+	} else {
+		nSpan = nShift - readings->nMin;
+	}
+
+	if (nSpan > 0xFFFFu || nSpan * nSpan > (__SQUARES_OVERFLOW - 1 - statistics->__nSquares) / readings->nNum) {
+		statistics->__nSquares = __SQUARES_OVERFLOW;
+
+		return;
+	}
+
+	statistics->__nSquares	+= readings->nSquares
+							 + 2 * (u32)nDelta * (u32)(readings->nSum - (i32)readings->nNum * readings->nMin)
+							 + (u32)readings->nNum * (u32)nDelta * (u32)nDelta;
+}
+
+/*!
+ *	Nimmt die Rohwerte eines Treibers in die
+ *	Zeitperiode auf. Die Summe wird bei einem Überlauf
+ *	auf den grössten bzw. kleinsten Wert begrenzt und
+ *	die Zeitperiode als ungültig markiert.
+ */
+static void __addReadings(__acquisition_t *acquisition, const Measure__readings_t *readings) {
+	if (readings->nNum == 0) {
+		return;
+	}
+
+	ASSERT(acquisition->__nNumReadings <= 0xFFFFu - readings->nNum);
+
+	if (acquisition->nStatistics != __NO_STATISTICS) {
+		__addStatistics(&__statistics[acquisition->nStatistics], acquisition->__nNumReadings == 0, readings);
+	}
+
+	if (readings->nSum > 0 && acquisition->__nReadings > INT32_MAX - readings->nSum) {
+		acquisition->__nReadings	= INT32_MAX;
+		acquisition->__bSaturated	= TRUE;
+	} else if (readings->nSum < 0 && acquisition->__nReadings < INT32_MIN - readings->nSum) {
+		acquisition->__nReadings	= INT32_MIN;
+		acquisition->__bSaturated	= TRUE;
+	} else {
+		acquisition->__nReadings	+= readings->nSum;
+	}
+
+	acquisition->__nNumReadings	+= readings->nNum;
+}
+
+/*!
+ *	Sichert Mittelwert, Anzahl, Extremwerte und
+ *	Varianz der abgelaufenen Zeitperiode.
+ */
+static void __finishStatistics(__statistics_t *statistics, i32 nReadings, u16 nNum, bool bSaturated) {
+	ldbl dVariance	= 0.0L;
+
+	if (statistics->__nSquares == __SQUARES_OVERFLOW || bSaturated == TRUE) {
+		dVariance = NAN;
+	} else if (nNum > 1) {
+		// Summe der verschobenen Rohwerte
+		ldbl dSum = nReadings - (i32)nNum * statistics->__nShift;
+
+		dVariance = ((ldbl)statistics->__nSquares - (dSum * dSum) / nNum) / (nNum - 1);
+
+		if (dVariance < 0.0L) {
+			dVariance = 0.0L;
+		}
+	}
+
+	statistics->__dLastMean			= (bSaturated == TRUE || nNum == 0 ? NAN : (ldbl)nReadings / nNum);
+	statistics->__nLastNumReadings	= nNum;
+	statistics->__nLastMin			= statistics->__nMin;
+	statistics->__nLastMax			= statistics->__nMax;
+	statistics->__dLastVariance		= dVariance;
+
+	statistics->__nSquares			= 0;
+}
+
+/*!
+ *	Berechnet den Messwert und sichert die Kennung der
+ *	abgelaufenen Zeitperiode und setzt die Summen für
+ *	die nächste Zeitperiode zurück.
+ *	Der Mittelwert wird einmal pro Zeitperiode in die Einheit
+ *	des Treibers umgerechnet. Falls keine Rohwerte gemessen
+ *	wurden wird der alte Messwert halbiert, eine begrenzte
+ *	Summe ergibt keinen gültigen Mittelwert.
+ */
+static void __finishWindow(__acquisition_t *acquisition) {
+	// Kennung nur gültig falls sie während der Zeitperiode nicht geändert wurde
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		acquisition->__nLastTag			= __nTag;
+		acquisition->__bLastTagValid	= (acquisition->__nTagSequence == __nTagSequence);
+	}
+
+	if (acquisition->nStatistics != __NO_STATISTICS) {
+		__finishStatistics(&__statistics[acquisition->nStatistics], acquisition->__nReadings, acquisition->__nNumReadings, acquisition->__bSaturated);
+	}
+
+	if (acquisition->__bSaturated == TRUE) {
+		acquisition->__dReading = NAN;
+	} else if (acquisition->__nNumReadings == 0) {
+		acquisition->__dReading /= 2;
+	} else {
+		ldbl dMean = (ldbl)acquisition->__nReadings / (ldbl)acquisition->__nNumReadings;
+
+		if (acquisition->toValueFNC != NULL) {
+			dMean = acquisition->toValueFNC(dMean);
+		}
+
+		acquisition->__dReading = dMean;
+	}
+
+	acquisition->__nReadings			= 0;
+	acquisition->__nNumReadings			= 0;
+	acquisition->__bSaturated			= FALSE;
+}
+
+/*!
+ *	Rechnet einen Rohwert mit den Funktionen der
+ *	Messaufgabe in den endgültigen Messwert um.
+ */
+static ldbl __convert(__acquisition_t *acquisition, ldbl dRawResult) {
+	if (acquisition->toValueFNC != NULL) {
+		dRawResult = acquisition->toValueFNC(dRawResult);
+	}
+
+	if (acquisition->cnvResultFNC != NULL) {
+		dRawResult = acquisition->cnvResultFNC(dRawResult);
+	}
+
+	return dRawResult;
+}
+
+/*!
+ *	Verteilt die Rohwerte der zusätzlichen Kanäle
+ *	an die entsprechenden Messaufgaben.
+ */
+static void __addChannelReadings(__id_t nID, const Measure__readings_t *readings) {
+	for (__id_t nChannelID = 0; nChannelID < __nAcquisitionLastID; ++nChannelID) {
+		__acquisition_t *channel = &__acquisitions[nChannelID];
+
+		if (channel->bIsChannel == TRUE && channel->nParentID == nID) {
+			__addReadings(channel, &readings[channel->nChannel]);
+		}
+	}
+}
+
+/*!
+ *	Beendet die Zeitperiode der zusätzlichen Kanäle.
+ */
+static void __finishChannelWindows(__id_t nID) {
+	for (__id_t nChannelID = 0; nChannelID < __nAcquisitionLastID; ++nChannelID) {
+		__acquisition_t *channel = &__acquisitions[nChannelID];
+
+		if (channel->bIsChannel == TRUE && channel->nParentID == nID) {
+			__finishWindow(channel);
+
+			__bTaskStatus[nChannelID] = TRUE;
+		}
+	}
+}
+
+static bool __doMeasurement(__id_t nID) {
+	Measure__readings_t readings[MEASURE_MAX_CHANNELS];
 	bool bDone						= FALSE;
 	__acquisition_t *acquisition	= &__acquisitions[nID];
 
@@ -70,7 +354,7 @@ static bool __doMeasurement(__id_t nID, ldbl *dReading) {
 	 *	wird beim Nächsten Aufruf von 'isDone' die
 	 *	Messung beendet.
 	 */
-	if (Timer__hasExpired() == TRUE && acquisition->bShouldFinish == FALSE) {
+	if (Timer__hasExpired(acquisition->nTimerID) == TRUE && acquisition->bShouldFinish == FALSE) {
 		if (acquisition->bMustFinish == FALSE) {
 			bDone = TRUE;
 		} else if (acquisition->bMustFinish == TRUE) {
@@ -95,14 +379,20 @@ static bool __doMeasurement(__id_t nID, ldbl *dReading) {
 		/*!
 		 *	Prüfen ob die Messung vorbei ist.
 		 *	Falls die Messung beendet wurde
-		 *	speichern wir das Messergebnis in
-		 *	__dReadings ab.
+		 *	summieren wir die Rohwerte in
+		 *	__nReadings auf.
+		 *	Die Umrechnung erfolgt erst beim Abholen
+		 *	des Messwertes (siehe Measure__getMeasuredValue).
 		 *	Wenn bShouldFinish auf 'TRUE' gesetzt ist
 		 *	beenden wir an diesem Zeitpunkt die Messung.
 		 */
-			if (acquisition->isDoneFNC(&dResult) == TRUE) {
-				acquisition->__dReadings	+= dResult;
-				acquisition->__nReadings	+= 1;
+			if (acquisition->isDoneFNC(readings) == TRUE) {
+				__addReadings(acquisition, &readings[0]);
+
+				if (acquisition->nChannels > 1) {
+					__addChannelReadings(nID, readings);
+				}
+
 				acquisition->__bStarted		 = FALSE;
 
 				if (acquisition->bShouldFinish == TRUE) {
@@ -113,7 +403,7 @@ static bool __doMeasurement(__id_t nID, ldbl *dReading) {
 	/*!
 	 *	Messung soll beendet werden.
 	 *	Flags werden zurückgesetzt sowie
-	 *	das Messergebnis berechnet.
+	 *	die Rohwerte der Zeitperiode gesichert.
 	 */
 	if (bDone == TRUE) {
 		if (acquisition->bShouldFinish == TRUE) {
@@ -122,22 +412,50 @@ static bool __doMeasurement(__id_t nID, ldbl *dReading) {
 
 		acquisition->bShouldFinish = FALSE;
 
-		if (acquisition->__nReadings == 0) {
-			acquisition->__dReading /= 2;
-		} else {
-			acquisition->__dReading = (acquisition->__dReadings / (ldbl)acquisition->__nReadings);
-		}
-
-		*dReading = acquisition->__dReading;
+		__finishWindow(acquisition);
 
-		acquisition->__dReadings	= 0.0L;
-		acquisition->__nReadings	= 0;
+		if (acquisition->nChannels > 1) {
+			__finishChannelWindows(nID);
+		}
 	}
 	
 	return bDone;
 }
+
+/*!
+ *	Sucht die nächste Messaufgabe welche
+ *	die gleiche Peripherie wie `nID` verwendet.
+ *	Zusätzliche Kanäle werden übersprungen.
+ *	Falls keine andere vorhanden ist wird
+ *	`nID` zurückgegeben.
+ */
+static __id_t __nextAcquisition(__id_t nID) {
+	Measure__resource_t nResource = __acquisitions[nID].nResource;
+	__id_t nNextID = nID;
+
+	do {
+		if (++nNextID == __nAcquisitionLastID) {
+			nNextID = 0;
+		}
+	} while (__acquisitions[nNextID].nResource != nResource || __acquisitions[nNextID].bIsChannel == TRUE);
+
+	return nNextID;
+}
 // Statische Definitionen --------------------------------
 
+/*!
+ *	@function	Measure__setReading
+ */
+void Measure__setReading(Measure__readings_t *readings, i32 nReading) {
+	ASSERT(readings != NULL);
+
+	readings->nSum		= nReading;
+	readings->nNum		= 1;
+	readings->nMin		= nReading;
+	readings->nMax		= nReading;
+	readings->nSquares	= 0;
+}
+
 /*!
  *	@function	Measure__addMeasurement
  */
@@ -145,33 +463,102 @@ __id_t Measure__addMeasurement(
 	Measure__startMeasurementFNC_t startFNC,
 	void *startFNCCTX,
 	Measure__isDoneFNC_t isDoneFNC,
+	Measure__toValueFNC_t toValueFNC,
 	bool bMustFinish,
 	Measure__cnvResultFNC_t cnvResultFNC,
-	u8 nTimeSlice
+	u16 nTimeSlice,
+	Measure__resource_t nResource
 ) {
 	__id_t nNewID = __nAcquisitionLastID;
 	__acquisition_t *acquisition = &__acquisitions[nNewID];
 
-	ASSERT(acquisition != NULL);
+	ASSERT(nNewID < __MAX_ACQUISITIONS);
 	ASSERT(startFNC != NULL);
 	ASSERT(isDoneFNC != NULL);
+	ASSERT(nResource < __MAX_RESOURCES);
 
 	// Variablen kopieren
 	acquisition	->	startMeasurementFNC		= startFNC;
 	acquisition	->	startMeasurementFNCCTX	= startFNCCTX;
 	acquisition	->	isDoneFNC				= isDoneFNC;
+	acquisition	->	toValueFNC				= toValueFNC;
 	acquisition	->	cnvResultFNC			= cnvResultFNC;
 	acquisition	->	__bStarted				= FALSE;
 	acquisition	->	__dReading				= 0.0L;
-	acquisition	->	__dReadings				= 0.0L;
 	acquisition	->	__nReadings				= 0;
+	acquisition	->	__nNumReadings			= 0;
+	acquisition	->	__bSaturated			= FALSE;
+	acquisition	->	__nTagSequence			= 0;
+	acquisition	->	__nLastTag				= 0;
+	acquisition	->	__bLastTagValid			= FALSE;
+	acquisition	->	nStatistics				= __NO_STATISTICS;
 	acquisition	->	bMustFinish				= bMustFinish;
 	acquisition	->	bShouldFinish			= FALSE;
 	acquisition	->	nTimeSlice				= nTimeSlice;
+	acquisition	->	nResource				= nResource;
+	acquisition	->	nTimerID				= Timer__create();
+	acquisition	->	nChannels				= 1;
+	acquisition	->	bIsChannel				= FALSE;
+
+	// Erste Messaufgabe der Peripherie wird zuerst ausgeführt
+	if (__bResourceUsed[nResource] == FALSE) {
+		__bResourceUsed[nResource]	= TRUE;
+		__nAcquisitionID[nResource]	= nNewID;
+	}
 
 	++__nAcquisitionLastID;
 
-	ASSERT(__MAX_ACQUISITIONS > __nAcquisitionLastID);
+	return nNewID;
+}
+
+/*!
+ *	@function	Measure__addChannel
+ */
+__id_t Measure__addChannel(
+	__id_t nParentID,
+	Measure__toValueFNC_t toValueFNC,
+	Measure__cnvResultFNC_t cnvResultFNC
+) {
+	__id_t nNewID = __nAcquisitionLastID;
+	__acquisition_t *acquisition	= &__acquisitions[nNewID];
+	__acquisition_t *parent			= &__acquisitions[nParentID];
+
+	ASSERT(nNewID < __MAX_ACQUISITIONS);
+	ASSERT(nParentID < __nAcquisitionLastID);
+	ASSERT(parent->bIsChannel == FALSE);
+	ASSERT(parent->nChannels < MEASURE_MAX_CHANNELS);
+
+	/*!
+	 *	Der Kanal wird nicht selbst ausgeführt,
+	 *	sondern erhält seine Rohwerte von der Messaufgabe.
+	 */
+	acquisition	->	startMeasurementFNC		= NULL;
+	acquisition	->	startMeasurementFNCCTX	= NULL;
+	acquisition	->	isDoneFNC				= NULL;
+	acquisition	->	toValueFNC				= toValueFNC;
+	acquisition	->	cnvResultFNC			= cnvResultFNC;
+	acquisition	->	__bStarted				= FALSE;
+	acquisition	->	__dReading				= 0.0L;
+	acquisition	->	__nReadings				= 0;
+	acquisition	->	__nNumReadings			= 0;
+	acquisition	->	__bSaturated			= FALSE;
+	acquisition	->	__nTagSequence			= 0;
+	acquisition	->	__nLastTag				= 0;
+	acquisition	->	__bLastTagValid			= FALSE;
+	acquisition	->	nStatistics				= __NO_STATISTICS;
+	acquisition	->	bMustFinish				= parent->bMustFinish;
+	acquisition	->	bShouldFinish			= FALSE;
+	acquisition	->	nTimeSlice				= parent->nTimeSlice;
+	acquisition	->	nResource				= parent->nResource;
+	acquisition	->	nTimerID				= parent->nTimerID;
+	acquisition	->	nChannels				= 1;
+	acquisition	->	bIsChannel				= TRUE;
+	acquisition	->	nParentID				= nParentID;
+	acquisition	->	nChannel				= parent->nChannels;
+
+	++parent->nChannels;
+
+	++__nAcquisitionLastID;
 
 	return nNewID;
 }
@@ -183,17 +570,17 @@ bool Measure__getMeasuredValue(__id_t nID, ldbl *dResult) {
 	ASSERT(dResult != NULL);
 
 	if (__bTaskStatus[nID] == TRUE) {
-		ldbl _dResult;
-
-		_dResult = __acquisitions[nID].__dReading;
+		__acquisition_t *acquisition = &__acquisitions[nID];
+		// Bereits beim Ende der Zeitperiode berechnet (siehe __finishWindow)
+		ldbl _dResult = acquisition->__dReading;
 
 		/*!
 		 *	Falls Funktion zum Umrechnung des Wertes
 		 *	angegeben wurde, wird diese nun
 		 *	aufgerufen.
 		 */
-		if (__acquisitions[nID].cnvResultFNC != NULL) {
-			_dResult = __acquisitions[nID].cnvResultFNC(_dResult);
+		if (acquisition->cnvResultFNC != NULL) {
+			_dResult = acquisition->cnvResultFNC(_dResult);
 		}
 
 		*dResult = _dResult;
@@ -206,6 +593,100 @@ bool Measure__getMeasuredValue(__id_t nID, ldbl *dResult) {
 	}
 }
 
+/*!
+ *	@function	Measure__enableStatistics
+ */
+void Measure__enableStatistics(__id_t nID) {
+	ASSERT(nID < __nAcquisitionLastID);
+	ASSERT(__nStatisticsLastID < MEASURE_MAX_STATISTICS);
+
+	if (__acquisitions[nID].nStatistics != __NO_STATISTICS) return;
+
+	// Statistik beginnt mit der nächsten Zeitperiode
+	ASSERT(__acquisitions[nID].__nNumReadings == 0);
+
+	__statistics[__nStatisticsLastID].__nLastNumReadings	= 0;
+	__statistics[__nStatisticsLastID].__nSquares			= 0;
+
+	__acquisitions[nID].nStatistics = __nStatisticsLastID++;
+}
+
+/*!
+ *	@function	Measure__getStatistics
+ */
+bool Measure__getStatistics(__id_t nID, Measure__statistics_t *statistics) {
+	ASSERT(nID < __nAcquisitionLastID);
+	ASSERT(statistics != NULL);
+
+	__acquisition_t *acquisition	= &__acquisitions[nID];
+
+	ASSERT(acquisition->nStatistics != __NO_STATISTICS);
+
+	__statistics_t *window			= &__statistics[acquisition->nStatistics];
+
+	statistics->nReadings = window->__nLastNumReadings;
+
+	if (window->__nLastNumReadings == 0) {
+		return FALSE;
+	}
+
+	{
+		ldbl dMean		= window->__dLastMean;
+		ldbl dStdDev	= sqrt(window->__dLastVariance);
+		ldbl dMin		= __convert(acquisition, window->__nLastMin);
+		ldbl dMax		= __convert(acquisition, window->__nLastMax);
+
+		statistics->dMean	= __convert(acquisition, dMean);
+
+		/*!
+		 *	Standardabweichung wird über die Steigung der
+		 *	Umrechnung beim Mittelwert übertragen, da die
+		 *	Umrechnung nicht linear sein muss (z.B. Frequenz).
+		 */
+		statistics->dStdDev	= __convert(acquisition, dMean + dStdDev) - statistics->dMean;
+
+		if (statistics->dStdDev < 0.0L) {
+			statistics->dStdDev = -statistics->dStdDev;
+		}
+
+		// Umrechnung kann fallend sein (Periodendauer -> Frequenz)
+		if (dMin > dMax) {
+			statistics->dMin	= dMax;
+			statistics->dMax	= dMin;
+		} else {
+			statistics->dMin	= dMin;
+			statistics->dMax	= dMax;
+		}
+	}
+
+	return TRUE;
+}
+
+/*!
+ *	@function	Measure__setTag
+ */
+void Measure__setTag(u32 nTag) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__nTag = nTag;
+
+		++__nTagSequence;
+	}
+}
+
+/*!
+ *	@function	Measure__getTag
+ */
+bool Measure__getTag(__id_t nID, u32 *nTag) {
+	ASSERT(nID < __nAcquisitionLastID);
+	ASSERT(nTag != NULL);
+
+	__acquisition_t *acquisition = &__acquisitions[nID];
+
+	*nTag = acquisition->__nLastTag;
+
+	return acquisition->__bLastTagValid;
+}
+
 /*!
  *	@function	Measure__acquire
  */
@@ -213,24 +694,34 @@ void Measure__acquire(void) {
 	INTERRUPTS_REQUIRED();
 	ASSERT(__nAcquisitionLastID > 0);
 
-	if (__bTaskStarted == FALSE) {
-		// Starten des Zählers mit der angegeben Zeitperiode
-		Timer__start(__acquisitions[__nAcquisitionID].nTimeSlice);
+	/*!
+	 *	Jede Peripherie arbeitet ihre Messaufgaben
+	 *	unabhängig von den anderen ab, jeweils mit
+	 *	der Zeitperiode der aktuellen Messaufgabe.
+	 */
+	for (u8 nResource = 0; nResource < __MAX_RESOURCES; ++nResource) {
+		if (__bResourceUsed[nResource] == FALSE) {
+			continue;
+		}
 
-		__bTaskStarted = TRUE;
-	} else {
-		// Schauen ob die Messung bzw. die Aufgabe abgearbeitet wurde
-		__bTaskStatus[__nAcquisitionID] = __doMeasurement(__nAcquisitionID, &__dResults[__nAcquisitionID]);
+		__id_t nID = __nAcquisitionID[nResource];
+
+		if (__bResourceStarted[nResource] == FALSE) {
+			// Starten des Zeitgebers mit der angegeben Zeitperiode
+			Timer__start(__acquisitions[nID].nTimerID, __acquisitions[nID].nTimeSlice);
+
+			__startWindow(nID);
 
-		if (__bTaskStatus[__nAcquisitionID] == TRUE) {
-			// Nächste Aufgabe auswählen
-			__bTaskStarted = FALSE;
-			__nAcquisitionID += 1;
+			__bResourceStarted[nResource] = TRUE;
+		} else
+		// Schauen ob die Messung bzw. die Aufgabe abgearbeitet wurde
+			if (__doMeasurement(nID) == TRUE) {
+				__bTaskStatus[nID] = TRUE;
 
-			if (__nAcquisitionID == __nAcquisitionLastID) {
-				__nAcquisitionID = 0;
+				// Nächste Aufgabe der Peripherie auswählen
+				__nAcquisitionID[nResource]		= __nextAcquisition(nID);
+				__bResourceStarted[nResource]	= FALSE;
 			}
-		}
 	}
 }
 
@@ -12,12 +12,74 @@
 
 	#include <common/common.h>
 
+	/*!
+	 *	Aufsummierte Rohwerte eines Treibers.
+	 *	Treiber die pro Aufruf nur einen Rohwert liefern
+	 *	können `Measure__setReading` verwenden.
+	 */
+	struct Measure__readings {
+		// Summe der Rohwerte
+		i32		nSum;
+		// Anzahl Rohwerte
+		u16		nNum;
+		// Kleinster und grösster Rohwert
+		i32		nMin;
+		i32		nMax;
+		// Summe der Quadrate der Abweichungen vom kleinsten Rohwert
+		u32		nSquares;
+	};
+
+	typedef		struct Measure__readings		Measure__readings_t;
+
+	// Maximale Anzahl Kanäle pro Messaufgabe (siehe Measure__addChannel)
+	#define MEASURE_MAX_CHANNELS	4u
+
+	/*!
+	 *	Maximale Anzahl Messaufgaben mit Statistik (siehe Measure__enableStatistics).
+	 *	measurements.c: Strom, Openkollektorfrequenz und Analogausgang des T400.
+	 */
+	#define MEASURE_MAX_STATISTICS	3u
+
 	typedef void (*Measure__startMeasurementFNC_t)(void *ctx);
-	typedef bool (*Measure__isDoneFNC_t)(ldbl *dResult);
+	typedef bool (*Measure__isDoneFNC_t)(Measure__readings_t *readings);
+	typedef ldbl (*Measure__toValueFNC_t)(ldbl dRawResult);
 	typedef ldbl (*Measure__cnvResultFNC_t)(ldbl dResult);
 
 	typedef u8 Measure__MeasurementID_t;
 
+	/*!
+	 *	Peripherie welche von einer Messaufgabe belegt wird.
+	 *	Messaufgaben mit unterschiedlicher Peripherie werden
+	 *	gleichzeitig im selben Zeitfenster ausgeführt.
+	 *	Messaufgaben mit derselben Peripherie kommen
+	 *	nacheinander an die Reihe.
+	 */
+	enum Measure__resource {
+		MeasureResIntADC		= 0,	// Interner ADC
+		MeasureResExtADC		= 1,	// Externer ADC (I2C)
+		MeasureResFreqCounter	= 2		// INT2 und Timer/Counter0
+	};
+
+	typedef		enum Measure__resource		Measure__resource_t;
+
+	/*!
+	 *	Statistik einer Zeitperiode.
+	 */
+	struct Measure__statistics {
+		// Kleinster Messwert
+		ldbl	dMin;
+		// Grösster Messwert
+		ldbl	dMax;
+		// Mittelwert
+		ldbl	dMean;
+		// Standardabweichung
+		ldbl	dStdDev;
+		// Anzahl Messwerte
+		u16		nReadings;
+	};
+
+	typedef		struct Measure__statistics		Measure__statistics_t;
+
 	/*!
 	 *	@function	Measure__addMeasurement
 	 *	@brief
@@ -30,6 +92,11 @@
 	 *	können hier übergeben werden.
 	 *	@param		isDoneFNC
 	 *	Funktion zum Prüfen ob die Messung abgeschlossen wurde.
+	 *	Gibt das Ergebnis als ganzzahlige Rohwerte zurück,
+	 *	bei mehreren Kanälen ein Eintrag pro Kanal.
+	 *	@param		toValueFNC
+	 *	Optionaler Parameter: Funktion zum Umrechnen des gemittelten
+	 *	Rohwertes. Wird nur einmal pro Zeitperiode aufgerufen.
 	 *	@param		bMustFinish
 	 *	Wenn auf 'TRUE' gesetzt muss die Messung
 	 *	auf jeden Fall abgeschlossen sein.
@@ -37,7 +104,9 @@
 	 *	Optionaler Parameter: falls angegeben kann der gemessene
 	 *	Wert mit der Funktion umgerechnet werden.
 	 *	@param		nTimeSlice
-	 *	Zeitperiode in denen die Messungen erfolgen sollen.
+	 *	Zeitperiode in Millisekunden in denen die Messungen erfolgen sollen.
+	 *	@param		nResource
+	 *	Peripherie welche von der Messaufgabe verwendet wird.
 	 *
 	 *	@return		Measure__MeasurementID_t
 	 *	ID für die Messaufgabe.
@@ -47,7 +116,48 @@
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	Measure__MeasurementID_t Measure__addMeasurement(Measure__startMeasurementFNC_t startFNC, void *startFNCCTX,  Measure__isDoneFNC_t isDoneFNC, bool bMustFinish, Measure__cnvResultFNC_t cnvResultFNC, u8 nTimeSlice);
+	Measure__MeasurementID_t Measure__addMeasurement(Measure__startMeasurementFNC_t startFNC, void *startFNCCTX,  Measure__isDoneFNC_t isDoneFNC, Measure__toValueFNC_t toValueFNC, bool bMustFinish, Measure__cnvResultFNC_t cnvResultFNC, u16 nTimeSlice, Measure__resource_t nResource);
+
+	/*!
+	 *	@function	Measure__addChannel
+	 *	@brief
+	 *	Fügt einer Messaufgabe einen zusätzlichen Kanal hinzu.
+	 *	Der Kanal wird nicht selbst ausgeführt, sondern erhält
+	 *	den nächsten Eintrag der Rohwerte welche die `isDoneFNC`
+	 *	Funktion der Messaufgabe liefert. Die Messwerte werden
+	 *	unter der zurückgegebenen ID veröffentlicht.
+	 *
+	 *	@param		nParentID
+	 *	ID der Messaufgabe.
+	 *	@param		toValueFNC
+	 *	Optionaler Parameter: Funktion zum Umrechnen des gemittelten
+	 *	Rohwertes.
+	 *	@param		cnvResultFNC
+	 *	Optionaler Parameter: falls angegeben kann der gemessene
+	 *	Wert mit der Funktion umgerechnet werden.
+	 *
+	 *	@return		Measure__MeasurementID_t
+	 *	ID für den Kanal.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	Measure__MeasurementID_t Measure__addChannel(Measure__MeasurementID_t nParentID, Measure__toValueFNC_t toValueFNC, Measure__cnvResultFNC_t cnvResultFNC);
+
+	/*!
+	 *	@function	Measure__setReading
+	 *	@brief
+	 *	Setzt `readings` auf einen einzelnen Rohwert.
+	 *
+	 *	@param		readings
+	 *	Pointer zu den Rohwerten.
+	 *	@param		nReading
+	 *	Rohwert.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Measure__setReading(Measure__readings_t *readings, i32 nReading);
 
 	/*!
 	 *	@function	Measure__getMeasuredValue
@@ -66,6 +176,8 @@
 	 *	@warning
 	 *		- Die Funktion gibt einen neuen Wert nur **einmal**
 	 *		  zurück.
+	 *		- Das Ergebnis ist NAN falls die Summe der Rohwerte
+	 *		  in der Zeitperiode übergelaufen ist.
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
@@ -74,10 +186,92 @@
 	 */
 	bool Measure__getMeasuredValue(Measure__MeasurementID_t nID, ldbl *dResult);
 
+	/*!
+	 *	@function	Measure__enableStatistics
+	 *	@brief
+	 *	Führt für die Messaufgabe bzw. den Kanal mit der ID `nID`
+	 *	Extremwerte und Varianz der Zeitperiode mit.
+	 *	Ohne diesen Aufruf werden nur die Mittelwerte gebildet.
+	 *
+	 *	@param		nID
+	 *	ID der Messaufgabe.
+	 *
+	 *	@warning
+	 *		- Höchstens MEASURE_MAX_STATISTICS Messaufgaben!
+	 *		- Muss vor dem ersten Measure__acquire aufgerufen werden.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Measure__enableStatistics(Measure__MeasurementID_t nID);
+
+	/*!
+	 *	@function	Measure__getStatistics
+	 *	@brief
+	 *	Gibt Minimum, Maximum, Mittelwert, Standardabweichung
+	 *	und Anzahl Messwerte der letzten abgeschlossenen
+	 *	Zeitperiode der Messaufgabe mit der ID `nID` zurück.
+	 *	Die Werte sind bereits umgerechnet (siehe cnvResultFNC).
+	 *
+	 *	@param		nID
+	 *	ID der Messaufgabe.
+	 *	@param		statistics
+	 *	Pointer zur Struktur in der die Statistik abgelegt werden soll.
+	 *
+	 *	@return		bool
+	 *	'TRUE' wenn in der Zeitperiode Messwerte gemessen wurden,
+	 *	ansonsten 'FALSE' (nur `nReadings` ist dann gültig).
+	 *
+	 *	@warning
+	 *		- Measure__enableStatistics muss vorher aufgerufen worden sein!
+	 *		- Im Gegensatz zu Measure__getMeasuredValue wird der Wert
+	 *		  nicht als abgeholt markiert.
+	 *		- `dStdDev` ist NAN falls die Quadratsumme übergelaufen ist,
+	 *		  `dMean` und `dStdDev` falls die Summe übergelaufen ist.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Measure__getStatistics(Measure__MeasurementID_t nID, Measure__statistics_t *statistics);
+
+	/*!
+	 *	@function	Measure__setTag
+	 *	@brief
+	 *	Setzt die Kennung der aktuellen Messbedingungen,
+	 *	z.B. die Frequenz des SigGen. Jede Zeitperiode
+	 *	übernimmt die Kennung bei ihrem Start.
+	 *	Darf auch aus einer ISR aufgerufen werden.
+	 *
+	 *	@param		nTag		Kennung.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Measure__setTag(u32 nTag);
+
+	/*!
+	 *	@function	Measure__getTag
+	 *	@brief
+	 *	Gibt die Kennung der letzten Zeitperiode zurück.
+	 *
+	 *	@param		nID			ID der Messaufgabe.
+	 *	@param		nTag		Hier wird die Kennung abgelegt.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls die Kennung während der ganzen Zeitperiode
+	 *	gleich geblieben ist, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Measure__getTag(Measure__MeasurementID_t nID, u32 *nTag);
+
 	/*!
 	 *	@function	Measure__acquire
 	 *	@brief
-	 *	Führt die Messaufgaben nacheinander aus.
+	 *	Führt die Messaufgaben aus. Pro Peripherie ist jeweils
+	 *	eine Messaufgabe aktiv, die Peripherien werden
+	 *	parallel mit ihrer eigenen Zeitperiode bedient.
 	 *
 	 *	@warning
 	 *		- Measure__addMeasurements muss vorher aufgerufen worden sein!
@@ -0,0 +1,261 @@
+/*!
+ *	@file		Relay.c
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#include <Relay/Relay.h>
+#include <Timer/Timer.h>	// Timer__*
+
+// Statische Definitionen --------------------------------
+// main.c reiht höchstens sechs Schritte auf einmal ein
+#define __QUEUE_SIZE	8u
+
+// Befehle, die unteren Bits enthalten das Relais
+#define __CMD_SET		0x00u
+#define __CMD_RESET		0x10u
+#define __CMD_DELAY		0x20u
+#define __CMD_MASK		0xF0u
+
+// Zustände
+#define __STATE_IDLE	0u
+#define __STATE_PULSE	1u
+#define __STATE_SETTLE	2u
+
+// Spulen (PORTA): K1 setzen PA1, rücksetzen PA0; K2 setzen PA2, rücksetzen PA3
+static const u8 __nSetCoil[2] PROGMEM		= {PA1, PA2};
+static const u8 __nResetCoil[2] PROGMEM	= {PA0, PA3};
+
+struct __step {
+	u8		nCommand;
+	// Nur für Pausen
+	u16		nTime;
+};
+
+static struct __step __steps[__QUEUE_SIZE];
+static volatile u8 __nHead			= 0;
+static volatile u8 __nLength		= 0;
+
+static u8 __nState					= __STATE_IDLE;
+static u16 __nRemaining				= 0;
+// Spule die gerade bestromt wird
+static u8 __nCoil					= 0;
+
+static volatile u8 __nPulse			= 25;
+static volatile u8 __nSettle		= 25;
+
+/*!
+ *	Gesetzte Relais (Bit = Relais). Nach dem Einschalten
+ *	ist der Zustand unbekannt, beide gelten als gesetzt.
+ */
+static volatile u8 __nSet			= _BV(RelayK1) | _BV(RelayK2);
+
+static bool __bEnabled				= FALSE;
+
+/*!
+ *	Beginnt den Schritt am Anfang der Warteschlange.
+ *	Wird in der ISR aufgerufen.
+ */
+static void __begin(void) {
+	struct __step *step	= &__steps[__nHead];
+	u8 nRelay			= step->nCommand & ~__CMD_MASK;
+
+	switch (step->nCommand & __CMD_MASK) {
+		case __CMD_DELAY:
+			__nRemaining	= step->nTime;
+			__nState		= __STATE_SETTLE;
+		return;
+
+		case __CMD_SET:
+			// Verriegelung: zuerst das andere Relais rücksetzen
+			if (__nSet & _BV(nRelay ^ 1u)) {
+				__nCoil = pgm_read_byte(&__nResetCoil[nRelay ^ 1u]);
+			} else {
+				__nCoil = pgm_read_byte(&__nSetCoil[nRelay]);
+			}
+		break;
+
+		default:
+			__nCoil = pgm_read_byte(&__nResetCoil[nRelay]);
+		break;
+	}
+
+	PORTA |= _BV(__nCoil);
+
+	__nRemaining	= __nPulse;
+	__nState		= __STATE_PULSE;
+}
+
+/*!
+ *	Beendet den Impuls der Spule `__nCoil`
+ *	und merkt sich den neuen Zustand.
+ *	Wird in der ISR aufgerufen.
+ */
+static void __endPulse(void) {
+	PORTA &= ~_BV(__nCoil);
+
+	for (u8 nRelay = 0; nRelay < 2; ++nRelay) {
+		if (__nCoil == pgm_read_byte(&__nSetCoil[nRelay])) {
+			__nSet |= _BV(nRelay);
+		} else if (__nCoil == pgm_read_byte(&__nResetCoil[nRelay])) {
+			__nSet &= ~_BV(nRelay);
+		}
+	}
+}
+
+/*!
+ *	Wird jede Millisekunde vom Timer (ISR) aufgerufen.
+ */
+static void __tick(Timer__ID_t nTimer) {
+	if (__nState == __STATE_PULSE) {
+		if (--__nRemaining > 0) return;
+
+		__endPulse();
+
+		__nRemaining	= __nSettle;
+		__nState		= __STATE_SETTLE;
+	}
+
+	if (__nState == __STATE_SETTLE) {
+		if (__nRemaining > 0 && --__nRemaining > 0) return;
+
+		__nState = __STATE_IDLE;
+
+		/*!
+		 *	Ein Setzen, vor dem das andere Relais rückgesetzt
+		 *	werden musste, bleibt in der Warteschlange.
+		 */
+		if ((__steps[__nHead].nCommand & __CMD_MASK) != __CMD_SET || __nCoil == pgm_read_byte(&__nSetCoil[__steps[__nHead].nCommand & ~__CMD_MASK])) {
+			if (++__nHead == __QUEUE_SIZE) {
+				__nHead = 0;
+			}
+
+			--__nLength;
+		}
+	}
+
+	if (__nState == __STATE_IDLE && __nLength > 0) {
+		__begin();
+	}
+}
+
+/*!
+ *	Reiht den Befehl `nCommand` ein.
+ */
+static bool __enqueue(u8 nCommand, u16 nTime) {
+	bool bQueued = FALSE;
+
+	ASSERT(__bEnabled == TRUE);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (__nLength < __QUEUE_SIZE) {
+			u8 nTail = __nHead + __nLength;
+
+			if (nTail >= __QUEUE_SIZE) {
+				nTail -= __QUEUE_SIZE;
+			}
+
+			__steps[nTail].nCommand	= nCommand;
+			__steps[nTail].nTime	= nTime;
+
+			++__nLength;
+
+			bQueued = TRUE;
+		}
+	}
+
+	return bQueued;
+}
+// Statische Definitionen --------------------------------
+
+/*!
+ *	@function	Relay__enable
+ */
+void Relay__enable(void) {
+	Timer__ID_t nTimer;
+
+	INTERRUPTS_REQUIRED();
+
+	if (__bEnabled) return;
+
+	// Spulen als Ausgänge, alle stromlos
+	PORTA &= ~(_BV(PA0) | _BV(PA1) | _BV(PA2) | _BV(PA3));
+	DDRA  |= _BV(PA0) | _BV(PA1) | _BV(PA2) | _BV(PA3);
+
+	nTimer = Timer__create();
+
+	Timer__setCallback(nTimer, __tick);
+	Timer__startPeriodic(nTimer, 1);
+
+	__bEnabled = TRUE;
+}
+
+/*!
+ *	@function	Relay__setTiming
+ */
+void Relay__setTiming(u8 nPulse, u8 nSettle) {
+	ASSERT(nPulse > 0);
+
+	__nPulse	= nPulse;
+	__nSettle	= nSettle;
+}
+
+/*!
+ *	@function	Relay__set
+ */
+bool Relay__set(Relay_ID_t nRelay) {
+	ASSERT(nRelay == RelayK1 || nRelay == RelayK2);
+
+	return __enqueue(__CMD_SET | nRelay, 0);
+}
+
+/*!
+ *	@function	Relay__reset
+ */
+bool Relay__reset(Relay_ID_t nRelay) {
+	ASSERT(nRelay == RelayK1 || nRelay == RelayK2);
+
+	return __enqueue(__CMD_RESET | nRelay, 0);
+}
+
+/*!
+ *	@function	Relay__resetAll
+ */
+bool Relay__resetAll(void) {
+	bool bQueued = FALSE;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		// Beide oder keiner
+		if (__nLength + 2u <= __QUEUE_SIZE) {
+			Relay__reset(RelayK1);
+			Relay__reset(RelayK2);
+
+			bQueued = TRUE;
+		}
+	}
+
+	return bQueued;
+}
+
+/*!
+ *	@function	Relay__delay
+ */
+bool Relay__delay(u16 nTime) {
+	return __enqueue(__CMD_DELAY, nTime);
+}
+
+/*!
+ *	@function	Relay__isDone
+ */
+bool Relay__isDone(void) {
+	return __nLength == 0;
+}
+
+/*!
+ *	@function	Relay__isSet
+ */
+bool Relay__isSet(Relay_ID_t nRelay) {
+	ASSERT(nRelay == RelayK1 || nRelay == RelayK2);
+
+	return BIT_ISSET(__nSet, nRelay);
+}
@@ -0,0 +1,161 @@
+/*!
+ *	@file		Relay.h
+ *	@brief
+ *	Ansteuerung der bistabilen Relais K1 und K2. Jedes Relais
+ *	hat eine Spule zum Setzen und eine zum Rücksetzen, die
+ *	jeweils kurz bestromt wird.
+ *
+ *	Die Befehle werden in eine Warteschlange eingereiht und vom
+ *	Timer im Millisekundentakt abgearbeitet. Jeder Impuls besteht
+ *	aus der Impulsdauer (Spule bestromt) und der Wartezeit bis
+ *	der Kontakt ruhig ist. Das Hauptprogramm wird dabei nicht
+ *	blockiert.
+ *
+ *	Verriegelung: Bevor ein Relais gesetzt wird, wird das andere
+ *	zurückgesetzt. K1 und K2 sind nie gleichzeitig gesetzt.
+ *
+ *	Beispiel:
+ *	Relais K1 setzen:
+ *	Relay__set(RelayK1);
+ *	Warten bis fertig (nicht blockierend):
+ *	Relay__isDone();
+ *
+ *	@warning
+ *		- Timer__enable muss vorher aufgerufen worden sein!
+ *		- PA0 bis PA3 gehören dem Modul, PORTA darf danach
+ *		  nur noch atomar verändert werden.
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#if !defined(JAQ_RELAY_H)
+	#define JAQ_RELAY_H 1
+
+	#include <common/common.h>
+
+	/*!
+	 *	Relais.
+	 */
+	enum Relay_ID {
+		RelayK1	= 0,
+		RelayK2	= 1
+	};
+
+	typedef		enum Relay_ID		Relay_ID_t;
+
+	/*!
+	 *	@function	Relay__enable
+	 *	@brief
+	 *	Aktiviert das Relay Modul. Die Spulenausgänge werden
+	 *	konfiguriert und der Zeitgeber gestartet.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Relay__enable(void);
+
+	/*!
+	 *	@function	Relay__setTiming
+	 *	@brief
+	 *	Setzt Impulsdauer und Wartezeit für alle
+	 *	folgenden Impulse (Standard 25ms / 25ms).
+	 *
+	 *	@param		nPulse		Impulsdauer in ms (min. 1).
+	 *	@param		nSettle		Wartezeit nach dem Impuls in ms.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Relay__setTiming(u8 nPulse, u8 nSettle);
+
+	/*!
+	 *	@function	Relay__set
+	 *	@brief
+	 *	Reiht das Setzen des Relais `nRelay` ein. Ist das andere
+	 *	Relais zu diesem Zeitpunkt gesetzt, wird es vorher
+	 *	zurückgesetzt.
+	 *
+	 *	@param		nRelay		Relais.
+	 *
+	 *	@return		bool
+	 *	'FALSE' falls die Warteschlange voll ist.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Relay__set(Relay_ID_t nRelay);
+
+	/*!
+	 *	@function	Relay__reset
+	 *	@brief
+	 *	Reiht das Rücksetzen des Relais `nRelay` ein.
+	 *
+	 *	@param		nRelay		Relais.
+	 *
+	 *	@return		bool
+	 *	'FALSE' falls die Warteschlange voll ist.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Relay__reset(Relay_ID_t nRelay);
+
+	/*!
+	 *	@function	Relay__resetAll
+	 *	@brief
+	 *	Reiht das Rücksetzen beider Relais ein.
+	 *
+	 *	@return		bool
+	 *	'FALSE' falls die Warteschlange voll ist.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Relay__resetAll(void);
+
+	/*!
+	 *	@function	Relay__delay
+	 *	@brief
+	 *	Reiht eine Pause von `nTime` ms ein, z.B. um einen
+	 *	Zustand eine bestimmte Zeit zu halten.
+	 *
+	 *	@param		nTime		Pause in ms.
+	 *
+	 *	@return		bool
+	 *	'FALSE' falls die Warteschlange voll ist.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Relay__delay(u16 nTime);
+
+	/*!
+	 *	@function	Relay__isDone
+	 *	@brief
+	 *	Prüft ob alle eingereihten Befehle abgearbeitet sind.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls die Warteschlange leer ist, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Relay__isDone(void);
+
+	/*!
+	 *	@function	Relay__isSet
+	 *	@brief
+	 *	Gibt den Zustand des Relais `nRelay` nach dem
+	 *	letzten abgeschlossenen Impuls zurück.
+	 *
+	 *	@param		nRelay		Relais.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls das Relais gesetzt ist, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool Relay__isSet(Relay_ID_t nRelay);
+
+#endif // !defined(JAQ_RELAY_H)
@@ -5,43 +5,253 @@
  *	@copyright	2016 <Marco Agnoli>
  */
 #include <SigGen/SigGen.h>
+#include <Timer/Timer.h>		// Timer_*
+#include <Measure/Measure.h>	// Measure_*
 
 // Statische Definitionen --------------------------------
-static volatile u8 __nOverflows		= 0;
-static volatile u8 __nOverflowsCtn	= 0;
-// Statische Definitionen --------------------------------
+#define __F_CPU				16000000ul
+// Takte pro Sekunde in Einheiten von 1/1000 (für Frequenzen in mHz)
+#define __F_CPU_MILLI		(__F_CPU * 1000ull)
+#define __NUM_PRESCALERS	5u
+
+// Vorteiler des Timer/Counter1 und die zugehörigen CS1x Bits
+static const u16 __nPrescalers[__NUM_PRESCALERS] PROGMEM	= {1, 8, 64, 256, 1024};
+static const u8 __nClockSelect[__NUM_PRESCALERS] PROGMEM	= {
+	_BV(CS10),
+	_BV(CS11),
+	_BV(CS11) | _BV(CS10),
+	_BV(CS12),
+	_BV(CS12) | _BV(CS10)
+};
 
 /*!
- *	ISR Prioritätenliste:
- *
- *	0 - TIMER1_COMPA_vect
- *	1 - TIMER1_OVF_vect
+ *	Einstellung des Timer/Counter1 für eine Frequenz.
+ *	Eine halbe Periode dauert
+ *	(nTop + 1) + (nRemainder / nDenominator) Zählerschritte.
+ *	Ist `nRemainder` 0 läuft der Timer ohne Interrupt.
  */
+struct __setting {
+	u32		nFrequency;		// mHz
+	u8		nClockSelect;
+	u16		nTop;
+	u32		nRemainder;
+	u32		nDenominator;
+};
+
+typedef		struct __setting		__setting_t;
+
+// Bruchteil der aktuellen Einstellung (siehe TIMER1_COMPA_vect)
+static volatile u16 __nTop			= 0;
+static volatile u32 __nRemainder	= 0;
+static volatile u32 __nDenominator	= 1;
+static volatile u32 __nAccumulator	= 0;
+
+// Aktuell ausgegebene Frequenz in mHz
+static volatile u32 __nFrequency	= 0;
+
+// Pulspaket: Anzahl noch zu erzeugende Flanken
+static volatile bool __bBurst		= FALSE;
+static volatile u32 __nBurstEdges	= 0;
+static volatile bool __bBurstDone	= TRUE;
 
 /*!
- **********************************************************
- * TIMER 1 COMPARE MATCH INTERRUPT
- **********************************************************
+ *	Schritt des Frequenzdurchlaufs, wird vor dem Start berechnet.
+ *	Die ISR des Zeitgebers lädt nur noch OCR1A und den Vorteiler.
  */
-ISR(TIMER1_COMPA_vect, ISR_BLOCK) {
-	if (__nOverflowsCtn == 0) {
-		PORTD ^= _BV(PD5);
+struct __sweepEntry {
+	u16		nTop;
+	// Bit 13 bis 15: CS1x Bits, Bit 0 bis 12: Frequenz in Hz
+	u16		nClockFrequency;
+};
+
+#define __SWEEP_CS_SHIFT	13u
+#define __SWEEP_HZ_MASK		0x1FFFu
+
+static struct __sweepEntry __sweepSteps[SIGGEN_MAX_SWEEP_STEPS];
+static volatile u8 __nSweepIndex	= 0;
+static u8 __nSweepSteps				= 0;
+static volatile bool __bSweeping	= FALSE;
+static Timer__ID_t __nSweepTimer;
+
+/*!
+ *	Berechnet die Einstellung für eine halbe Periode
+ *	von `nNumerator / nDenominator` CPU Takten.
+ *	Bevorzugt wird der kleinste Vorteiler, mit dem die
+ *	Periode exakt erzeugt werden kann. Ist das mit keinem
+ *	Vorteiler möglich, wird der kleinste passende Vorteiler
+ *	mit Bruchteil verwendet.
+ *	Für ganzzahlige Frequenzen genügt eine 32 Bit Division.
+ */
+static void __compute(u64 nNumerator, u64 nDenominator, __setting_t *setting) {
+	bool bFound = FALSE;
+
+	ASSERT(setting != NULL);
+	ASSERT(nDenominator > 0);
+
+	setting->nFrequency = 0;
+
+	for (u8 nI = 0; nI < __NUM_PRESCALERS; ++nI) {
+		u64 nDivisor	= nDenominator * pgm_read_word(&__nPrescalers[nI]);
+		u64 nCounts;
+		u64 nRemainder;
 
-		__nOverflowsCtn = __nOverflows;
+		// Akkumulator + Bruchteil muss in 32 Bit passen (siehe TIMER1_COMPA_vect)
+		if (nDivisor > 0x7FFFFFFFull) {
+			continue;
+		}
 
-		TCNT1 = 0;
+		if (nNumerator <= 0xFFFFFFFFull) {
+			nCounts		= (u32)nNumerator / (u32)nDivisor;
+			nRemainder	= (u32)nNumerator % (u32)nDivisor;
+		} else {
+			nCounts		= nNumerator / nDivisor;
+			nRemainder	= nNumerator % nDivisor;
+		}
+
+		// Obere Grenze inkl. Bruchteil muss in OCR1A passen
+		if (nCounts < 1 || nCounts + (nRemainder > 0) > 0x10000ul) {
+			continue;
+		}
+
+		if (bFound == FALSE || nRemainder == 0) {
+			setting->nClockSelect	= pgm_read_byte(&__nClockSelect[nI]);
+			setting->nTop			= nCounts - 1;
+			setting->nRemainder		= nRemainder;
+			setting->nDenominator	= nDivisor;
+
+			bFound = TRUE;
+		}
+
+		if (nRemainder == 0) {
+			break;
+		}
 	}
+
+	ASSERT(bFound == TRUE);
+}
+
+static void __apply(const __setting_t *setting) {
+	// Timer 1 stoppen
+	TCCR1B = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__nTop			= setting->nTop;
+		__nRemainder	= setting->nRemainder;
+		__nDenominator	= setting->nDenominator;
+		__nAccumulator	= 0;
+
+		OCR1A			= setting->nTop;
+		TCNT1			= 0;
+	}
+
+	// Interrupt wird nur für den Bruchteil oder das Pulspaket benötigt
+	if (setting->nRemainder > 0 || __bBurst) {
+		// Flag wird mit 1 gelöscht, läuft auch in TIMER2_COMP (Durchlauf)
+		TIFR   = _BV(OCF1A);
+		TIMSK |= _BV(OCIE1A);
+	} else {
+		TIMSK &= ~_BV(OCIE1A);
+	}
+
+	// CTC Modus, OC1A wird bei Compare Match umgeschaltet
+	TCCR1A = _BV(COM1A0);
+	TCCR1B = _BV(WGM12) | setting->nClockSelect;
+
+	// Messwerte mit der Frequenz kennzeichnen
+	__nFrequency = setting->nFrequency;
+
+	Measure__setTag(setting->nFrequency);
+}
+
+static void __stopBurst(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__bBurst		= FALSE;
+		__bBurstDone	= TRUE;
+	}
+}
+
+static void __stopSweep(void) {
+	if (__bSweeping) {
+		Timer__stop(__nSweepTimer);
+
+		__bSweeping = FALSE;
+	}
+}
+
+/*!
+ *	Setzt den vorberechneten Schritt `__nSweepIndex`.
+ *	Wird auch in der ISR aufgerufen.
+ */
+static void __sweepApply(void) {
+	const struct __sweepEntry *step	= &__sweepSteps[__nSweepIndex];
+	__setting_t setting;
+
+	setting.nClockSelect	= step->nClockFrequency >> __SWEEP_CS_SHIFT;
+	setting.nTop			= step->nTop;
+	setting.nRemainder		= 0;
+	setting.nDenominator	= 1;
+	setting.nFrequency		= (step->nClockFrequency & __SWEEP_HZ_MASK) * 1000ul;
+
+	__apply(&setting);
 }
 
+/*!
+ *	Wird vom Zeitgeber nach jeder Verweilzeit in der ISR aufgerufen.
+ */
+static void __sweepStep(Timer__ID_t nTimer) {
+	if (++__nSweepIndex >= __nSweepSteps) {
+		// Letzte Frequenz bleibt eingestellt
+		Timer__stop(nTimer);
+
+		__bSweeping = FALSE;
+	} else {
+		__sweepApply();
+	}
+}
+// Statische Definitionen --------------------------------
+
 /*!
  **********************************************************
- * TIMER 1 OVERFLOW INTERRUPT
+ * TIMER 1 COMPARE MATCH INTERRUPT
  **********************************************************
+ *	Wird nur aufgerufen falls die Frequenz nicht exakt
+ *	erzeugt werden kann. Der Zähler wurde bereits auf 0
+ *	gesetzt, OCR1A gilt für die laufende halbe Periode.
+ *	Die Bruchteile werden wie bei einem Phasenakkumulator
+ *	aufsummiert und jeweils eine halbe Periode um einen
+ *	Zählerschritt verlängert. Die mittlere Frequenz
+ *	ist dadurch exakt.
+ *	Bei einem Pulspaket wird nach der letzten Flanke
+ *	der Timer gestoppt.
  */
-ISR(TIMER1_OVF_vect, ISR_BLOCK) {
-	ASSERT(__nOverflowsCtn > 0);
+ISR(TIMER1_COMPA_vect, ISR_BLOCK) {
+	if (__bBurst && --__nBurstEdges == 0) {
+		// Letzte Flanke wurde von der Hardware erzeugt, Ausgang ist low
+		TCCR1B	= 0;
+		TCCR1A	= 0;
+		TIMSK	&= ~_BV(OCIE1A);
+
+		__bBurst		= FALSE;
+		__bBurstDone	= TRUE;
+		__nFrequency	= 0;
+
+		// Ab hier liegt kein Signal mehr an (siehe SigGen__disable)
+		Measure__setTag(0);
+
+		return;
+	}
 
-	--__nOverflowsCtn;
+	u32 nAccumulator = __nAccumulator + __nRemainder;
+
+	if (nAccumulator >= __nDenominator) {
+		nAccumulator -= __nDenominator;
+
+		OCR1A = __nTop + 1;
+	} else {
+		OCR1A = __nTop;
+	}
+
+	__nAccumulator = nAccumulator;
 }
 
 /*!
@@ -50,57 +260,189 @@ ISR(TIMER1_OVF_vect, ISR_BLOCK) {
 void SigGen__enable(void) {
 	// Pin als Ausgang konfigurieren
 	DDRD |= _BV(PD5);
+
+	// Zeitgeber für den Frequenzdurchlauf
+	__nSweepTimer = Timer__create();
+
+	Timer__setCallback(__nSweepTimer, __sweepStep);
 }
 
 /*!
  *	@function	SigGen__setFrequency
  */
 void SigGen__setFrequency(u16 nFrequency) {
-	INTERRUPTS_REQUIRED();
 	ASSERT(nFrequency <= 5E3);
 
-	ldbl 	dTemp			= (16.0E6 / ((ldbl)nFrequency * 2.0L));
-	bool	bIsLowFreq		= (nFrequency < 200u);
-	u8		nOverflows		= (bIsLowFreq ? dTemp / 65535u : 0);
-	u16		nRemainder		= ((u32)dTemp) % 65535u;
+	SigGen__setFrequencyMilli(nFrequency * 1000ul);
+}
 
-	ASSERT(nOverflows <= 255);
+/*!
+ *	@function	SigGen__setFrequencyMilli
+ */
+void SigGen__setFrequencyMilli(u32 nMilliHertz) {
+	INTERRUPTS_REQUIRED();
+	ASSERT(nMilliHertz <= SIGGEN_MAX_MILLIHERTZ);
 
-	// Timer 1 stoppen
-	TCCR1B = 0;
-	TCCR1A = 0;
+	__stopSweep();
+	__stopBurst();
 
-	if (bIsLowFreq == TRUE) {
-		// Overflow und Compare Match Interrupte aktivieren
-		TIMSK |= _BV(TOIE1);
-		TIMSK |= _BV(OCIE1A);
-		// Waveform Generator deaktivieren
-		TCCR1A &= ~_BV(COM1A0);
-		TCCR1B &= ~_BV(WGM12);
-	} else {
-		// Waveform Generator aktivieren
-		TCCR1A |= _BV(COM1A0);
-		TCCR1B |= _BV(WGM12);
-		// Overflow und Compare Match Interrupte deaktivieren
-		TIMSK &= ~_BV(TOIE1);
-		TIMSK &= ~_BV(OCIE1A);
+	// 0Hz: Ausgang abschalten
+	if (nMilliHertz == 0) {
+		SigGen__disable();
+
+		return;
+	}
+
+	// Langsamer kann Timer/Counter1 nicht zählen
+	if (nMilliHertz < SIGGEN_MIN_MILLIHERTZ) {
+		nMilliHertz = SIGGEN_MIN_MILLIHERTZ;
+	}
+
+	{
+		__setting_t setting;
+
+		// Halbe Periode = F_CPU / (2 * f) Takte
+		__compute(__F_CPU_MILLI, 2ull * nMilliHertz, &setting);
+
+		setting.nFrequency = nMilliHertz;
+
+		__apply(&setting);
+	}
+}
+
+/*!
+ *	@function	SigGen__sweep
+ */
+void SigGen__sweep(u16 nStartFrequency, u16 nStopFrequency, u8 nSteps, SigGen_spacing_t nSpacing, u16 nDwell) {
+	INTERRUPTS_REQUIRED();
+	ASSERT(nStartFrequency > 0 && nStartFrequency <= 5E3);
+	ASSERT(nStopFrequency > 0 && nStopFrequency <= 5E3);
+	ASSERT(nSteps >= 2 && nSteps <= SIGGEN_MAX_SWEEP_STEPS);
+	ASSERT(nDwell > 0);
+
+	__stopSweep();
+	__stopBurst();
+
+	{
+		// Verhältnis zweier Schritte nur einmal berechnen (pow ist teuer)
+		ldbl dRatio		= pow((ldbl)nStopFrequency / nStartFrequency, 1.0L / (nSteps - 1));
+		ldbl dFrequency	= nStartFrequency;
+
+		for (u8 nI = 0; nI < nSteps; ++nI) {
+			__setting_t setting;
+			u16 nFrequency;
+
+			if (nI == 0) {
+				nFrequency	= nStartFrequency;
+			} else if (nI == nSteps - 1) {
+				// Rundungsfehler nicht bis zur Stoppfrequenz mitnehmen
+				nFrequency	= nStopFrequency;
+			} else if (nSpacing == SigGenLogarithmic) {
+				dFrequency	*= dRatio;
+				nFrequency	= (u16)(dFrequency + 0.5L);
+			} else {
+				i32 nSpan = (i32)nStopFrequency - nStartFrequency;
+
+				nFrequency	= nStartFrequency + (nSpan * nI) / (nSteps - 1);
+			}
+
+			__compute(__F_CPU, 2ul * nFrequency, &setting);
+
+			// Bruchteil auf ganze Zählerschritte runden
+			if (2ul * setting.nRemainder >= setting.nDenominator && setting.nTop < 0xFFFFu) {
+				++setting.nTop;
+			}
+
+			__sweepSteps[nI].nTop				= setting.nTop;
+			__sweepSteps[nI].nClockFrequency	= ((u16)setting.nClockSelect << __SWEEP_CS_SHIFT) | nFrequency;
+		}
 	}
 
-	// Atomar neue Variablen schreiben
+	__nSweepSteps	= nSteps;
+	__nSweepIndex	= 0;
+	__bSweeping		= TRUE;
+
+	__sweepApply();
+
+	Timer__startPeriodic(__nSweepTimer, nDwell);
+}
+
+/*!
+ *	@function	SigGen__burst
+ */
+void SigGen__burst(u16 nPulses, u16 nFrequency) {
+	INTERRUPTS_REQUIRED();
+	ASSERT(nPulses > 0);
+	ASSERT(nFrequency > 0 && nFrequency <= SIGGEN_MAX_BURST_FREQUENCY);
+
+	__stopSweep();
+
+	{
+		__setting_t setting;
+
+		__compute(__F_CPU, 2ul * nFrequency, &setting);
+
+		setting.nFrequency = nFrequency * 1000ul;
+
+		// Timer stoppen und OC1A auf low zwingen
+		TCCR1B = 0;
+		TCCR1A = _BV(COM1A1) | _BV(FOC1A);
+
+		// Zwei Flanken pro Puls
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			__nBurstEdges	= 2ul * nPulses;
+			__bBurst		= TRUE;
+			__bBurstDone	= FALSE;
+		}
+
+		__apply(&setting);
+	}
+}
+
+/*!
+ *	@function	SigGen__isBurstDone
+ */
+bool SigGen__isBurstDone(void) {
+	return __bBurstDone;
+}
+
+/*!
+ *	@function	SigGen__isSweeping
+ */
+bool SigGen__isSweeping(void) {
+	return __bSweeping;
+}
+
+/*!
+ *	@function	SigGen__getFrequency
+ */
+u32 SigGen__getFrequency(void) {
+	u32 nFrequency;
+
 	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-		__nOverflows	= nOverflows;
-		__nOverflowsCtn	= __nOverflows;
-		OCR1A			= nRemainder;
-		TCNT1			= 0;
+		nFrequency = __nFrequency;
 	}
 
-	// Timer mit der höchsten Auflösung starten
-	TCCR1B |= _BV(CS10);
+	return nFrequency;
 }
 
 /*!
  *	@function	SigGen__disable
  */
 void SigGen__disable(void) {
-	
+	__stopSweep();
+	__stopBurst();
+
+	// Timer 1 stoppen und freigeben
+	TCCR1B = 0;
+	TCCR1A = 0;
+
+	// Compare Match Interrupt deaktivieren
+	TIMSK &= ~_BV(OCIE1A);
+
+	PORTD &= ~_BV(PD5);
+
+	__nFrequency = 0;
+
+	Measure__setTag(0);
 }
@@ -4,12 +4,28 @@
  *	Modul zur Generierung des Sensorsignals.
  *	Mit `SigGen__setFrequency` lässt sich die
  *	Frequenz im Bereich von 0 bis 5kHz einstellen.
+ *	Das Signal wird vom Timer/Counter1 im CTC Modus direkt
+ *	an OC1A (PD5) erzeugt. Der Vorteiler (1, 8, 64, 256, 1024)
+ *	wird so gewählt, dass die Frequenz möglichst ohne
+ *	Interrupt exakt erzeugt werden kann. Ansonsten wird
+ *	der Bruchteil im Compare Match Interrupt ausgeglichen.
  *
  *	Beispiel:
  *	Modul aktivieren:
  *	SigGen__enable();
  *	Stellt Frequenz auf 50Hz ein:
  *	SigGen__setFrequency(50);
+ *	Frequenzdurchlauf von 10Hz bis 5kHz in 16 logarithmischen
+ *	Schritten mit je 2 Sekunden Verweilzeit:
+ *	SigGen__sweep(10, 5000, 16, SigGenLogarithmic, 2000);
+ *
+ *	Genau 10 Pulse mit 100Hz ausgeben:
+ *	SigGen__burst(10, 100);
+ *	Prüfen ob alle Pulse ausgegeben wurden:
+ *	SigGen__isBurstDone();
+ *
+ *	Die ausgegebene Frequenz (in mHz) wird als Kennung der
+ *	Messwerte gesetzt (siehe Measure__getTag).
  *
  *	@warning
  *		- Interrupte müssen aktiviert sein.
@@ -22,10 +38,39 @@
 
 	#include <common/common.h>
 
+	// Maximale Anzahl Schritte eines Frequenzdurchlaufs
+	#define SIGGEN_MAX_SWEEP_STEPS	16u
+
+	/*!
+	 *	Kleinste erzeugbare Frequenz in mHz: eine halbe Periode
+	 *	dauert höchstens 65536 Zählerschritte mit Vorteiler 1024,
+	 *	F_CPU / (2 * 1024 * 65536) = 119.2mHz.
+	 */
+	#define SIGGEN_MIN_MILLIHERTZ	120ul
+	#define SIGGEN_MAX_MILLIHERTZ	5000000ul
+
+	/*!
+	 *	Höchste Frequenz eines Pulspakets in Hz. Die Flanken werden
+	 *	im Compare Match Interrupt gezählt, er muss innerhalb einer
+	 *	halben Periode laufen. Im ungünstigsten Fall blockieren die
+	 *	anderen ISRs (Timer2 mit allen Zeitgebern, ADC, INT2, TWI,
+	 *	ICP1) zusammen rund 100us. Mit 1kHz (500us) bleibt die
+	 *	fünffache Reserve.
+	 */
+	#define SIGGEN_MAX_BURST_FREQUENCY	1000u
+
+	enum SigGen__spacing {
+		SigGenLinear		= 0,	// Gleiche Abstände
+		SigGenLogarithmic	= 1		// Gleiche Verhältnisse
+	};
+
+	typedef		enum SigGen__spacing		SigGen_spacing_t;
+
 	/*!
 	 *	@function	SigGen__enable
 	 *	@brief
 	 *	Aktiviert das SigGen Modul.
+	 *	Legt einen Zeitgeber an (siehe Timer__create).
 	 */
 	void SigGen__enable(void);
 
@@ -36,16 +81,126 @@
 	 *	Bereich von 0 bis 5kHz.
 	 *
 	 *	@param		nFrequency	Frequenz im Bereich von 0 bis 5kHz.
+	 *	Bei 0Hz wird der Ausgang abgeschaltet.
 	 *
 	 *	@warning
 	 *		- SigGen__enable muss vorher aufgerufen worden sein!
 	 */
 	void SigGen__setFrequency(u16 nFrequency);
 
+	/*!
+	 *	@function	SigGen__setFrequencyMilli
+	 *	@brief
+	 *	Setzt die Frequenz auf ein Millihertz genau.
+	 *	Kann die Frequenz nicht exakt erzeugt werden, wird
+	 *	OCR1A im Compare Match Interrupt zwischen zwei
+	 *	benachbarten Werten umgeschaltet (Phasenakkumulator).
+	 *	Die mittlere Frequenz ist dadurch exakt.
+	 *
+	 *	@param		nMilliHertz	Frequenz in mHz, 0 oder SIGGEN_MIN_MILLIHERTZ
+	 *	bis SIGGEN_MAX_MILLIHERTZ. Bei 0 wird der Ausgang abgeschaltet.
+	 *
+	 *	@warning
+	 *		- SigGen__enable muss vorher aufgerufen worden sein!
+	 *		- Frequenzen zwischen 0 und SIGGEN_MIN_MILLIHERTZ werden
+	 *		  auf SIGGEN_MIN_MILLIHERTZ angehoben (siehe SigGen__getFrequency).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void SigGen__setFrequencyMilli(u32 nMilliHertz);
+
+	/*!
+	 *	@function	SigGen__sweep
+	 *	@brief
+	 *	Startet einen Frequenzdurchlauf. OCR1A und Vorteiler aller
+	 *	Schritte werden im Voraus berechnet, danach schaltet
+	 *	ein Zeitgeber ohne Hauptprogramm weiter. Nach dem letzten
+	 *	Schritt bleibt die Stoppfrequenz eingestellt.
+	 *	Die Schritte werden ohne Bruchteil erzeugt, die Abweichung
+	 *	beträgt höchstens eine halbe Zählerperiode (< 0.04%).
+	 *	Ein Aufruf von `SigGen__setFrequency` bricht den Durchlauf ab.
+	 *
+	 *	@param		nStartFrequency	Startfrequenz (1Hz bis 5kHz).
+	 *	@param		nStopFrequency	Stoppfrequenz (1Hz bis 5kHz).
+	 *	@param		nSteps			Anzahl Schritte inkl. Start und Stopp
+	 *								(2 bis SIGGEN_MAX_SWEEP_STEPS).
+	 *	@param		nSpacing		Lineare oder logarithmische Abstände.
+	 *	@param		nDwell			Verweilzeit pro Schritt in Millisekunden.
+	 *
+	 *	@warning
+	 *		- Timer__enable muss vorher aufgerufen worden sein!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void SigGen__sweep(u16 nStartFrequency, u16 nStopFrequency, u8 nSteps, SigGen_spacing_t nSpacing, u16 nDwell);
+
+	/*!
+	 *	@function	SigGen__burst
+	 *	@brief
+	 *	Gibt genau `nPulses` Pulse mit der Frequenz `nFrequency`
+	 *	aus und stoppt danach. Der Ausgang bleibt low.
+	 *	Die Flanken werden von der Hardware erzeugt, gezählt
+	 *	wird im Compare Match Interrupt.
+	 *	Bricht einen laufenden Frequenzdurchlauf ab.
+	 *
+	 *	@param		nPulses		Anzahl Pulse.
+	 *	@param		nFrequency	Frequenz (1Hz bis SIGGEN_MAX_BURST_FREQUENCY).
+	 *
+	 *	@warning
+	 *		- Keine ISR darf länger als eine halbe Periode blockieren,
+	 *		  sonst gehen Flanken verloren (siehe SIGGEN_MAX_BURST_FREQUENCY).
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void SigGen__burst(u16 nPulses, u16 nFrequency);
+
+	/*!
+	 *	@function	SigGen__isBurstDone
+	 *	@brief
+	 *	Gibt an ob das Pulspaket vollständig ausgegeben wurde.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls kein Pulspaket läuft, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool SigGen__isBurstDone(void);
+
+	/*!
+	 *	@function	SigGen__isSweeping
+	 *	@brief
+	 *	Gibt an ob ein Frequenzdurchlauf läuft.
+	 *
+	 *	@return		bool
+	 *	'TRUE' während dem Durchlauf, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool SigGen__isSweeping(void);
+
+	/*!
+	 *	@function	SigGen__getFrequency
+	 *	@brief
+	 *	Gibt die aktuell ausgegebene Frequenz zurück.
+	 *
+	 *	@return		u32
+	 *	Frequenz in mHz.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u32 SigGen__getFrequency(void);
+
 	/*!
 	 *	@function	SigGen__disable
 	 *	@brief
-	 *	Deaktiviert das SigGen Modul.
+	 *	Deaktiviert das SigGen Modul und gibt
+	 *	den Timer/Counter1 frei.
 	 */
 	void SigGen__disable(void);
 
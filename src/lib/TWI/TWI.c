@@ -7,8 +7,180 @@
 #include <TWI/TWI.h>
 
 #define __FLAGS		_BV(TWEN) | _BV(TWINT)
+#define __FLAGS_IE	_BV(TWEN) | _BV(TWINT) | _BV(TWIE)
 #define __WAIT()		while (!BIT_ISSET(TWCR, TWINT))
 
+// Statische Definitionen --------------------------------
+#define __QUEUE_SIZE	4u
+
+// Warteschlange der Transaktionen, die erste wird gerade ausgeführt
+static TWI__transaction_t * volatile __queue[__QUEUE_SIZE];
+static volatile u8 __nQueueHead		= 0;
+static volatile u8 __nQueueLength	= 0;
+
+// Index des nächsten Bytes der aktuellen Transaktion
+static volatile u8 __nIndex			= 0;
+
+// Flag ob gerade eine Transaktion abgeschlossen wird (siehe __complete)
+static volatile bool __bCompleting	= FALSE;
+
+static INLINE TWI__transaction_t *__current(void) {
+	return __queue[__nQueueHead];
+}
+
+/*!
+ *	Schliesst die aktuelle Transaktion ab und startet
+ *	die nächste. Wird nur von der ISR aufgerufen.
+ */
+static void __complete(bool bError) {
+	TWI__transaction_t *transaction = __current();
+
+	transaction->bError	= bError;
+	transaction->bDone	= TRUE;
+
+	if (++__nQueueHead == __QUEUE_SIZE) {
+		__nQueueHead = 0;
+	}
+
+	--__nQueueLength;
+
+	// Rückruffunktion darf neue Transaktionen einreihen
+	if (transaction->callbackFNC != NULL) {
+		__bCompleting = TRUE;
+		transaction->callbackFNC(transaction);
+		__bCompleting = FALSE;
+	}
+
+	if (__nQueueLength > 0) {
+		// STOP- gefolgt von START-Kondition
+		__nIndex	= 0;
+		TWCR		= __FLAGS_IE | _BV(TWSTO) | _BV(TWSTA);
+	} else {
+		// I2C Bus befreien
+		TWCR		= __FLAGS | _BV(TWSTO);
+	}
+}
+// Statische Definitionen --------------------------------
+
+/*!
+ **********************************************************
+ * TWO-WIRE SERIAL INTERFACE INTERRUPT
+ **********************************************************
+ *	Wird nach jedem Schritt auf dem I2C Bus aufgerufen
+ *	und führt die aktuelle Transaktion weiter.
+ */
+ISR(TWI_vect, ISR_BLOCK) {
+	TWI__transaction_t *transaction = __current();
+
+	switch (TWI_STATUS) {
+		case TWI_STATUS__START:
+		case TWI_STATUS__RSTART: {
+			// Zuerst alle Bytes schreiben, danach lesen
+			if (__nIndex < transaction->nNumWrite) {
+				TWDR = transaction->nAddr & 0b11111110;
+			} else {
+				TWDR = transaction->nAddr | 0b00000001;
+			}
+
+			TWCR = __FLAGS_IE;
+		} break;
+
+		case TWI_STATUS__SLAW_ACK:
+		case TWI_STATUS__WRITE_ACK: {
+			if (__nIndex < transaction->nNumWrite) {
+				TWDR = transaction->nWriteBytes[__nIndex++];
+				TWCR = __FLAGS_IE;
+			} else if (transaction->nNumRead > 0) {
+				TWCR = __FLAGS_IE | _BV(TWSTA);
+			} else {
+				__complete(FALSE);
+			}
+		} break;
+
+		case TWI_STATUS__SLAR_ACK: {
+			__nIndex = 0;
+
+			// Beim letzten Byte wird mit NACK geantwortet
+			if (transaction->nNumRead > 1) {
+				TWCR = __FLAGS_IE | _BV(TWEA);
+			} else {
+				TWCR = __FLAGS_IE;
+			}
+		} break;
+
+		case TWI_STATUS__READ_ACK: {
+			transaction->nReadBytes[__nIndex++] = TWDR;
+
+			if (__nIndex < transaction->nNumRead - 1) {
+				TWCR = __FLAGS_IE | _BV(TWEA);
+			} else {
+				TWCR = __FLAGS_IE;
+			}
+		} break;
+
+		case TWI_STATUS__READ_NACK: {
+			transaction->nReadBytes[__nIndex] = TWDR;
+
+			__complete(FALSE);
+		} break;
+
+		default: {
+			// NACK vom Slave, Arbitrierung verloren oder Busfehler
+			__complete(TRUE);
+		} break;
+	}
+}
+
+/*!
+ *	@function	TWI__submit
+ */
+bool TWI__submit(TWI__transaction_t *transaction) {
+	bool bSubmitted = FALSE;
+
+	ASSERT(transaction != NULL);
+	ASSERT(transaction->nNumWrite == 0 || transaction->nWriteBytes != NULL);
+	ASSERT(transaction->nNumRead == 0 || transaction->nReadBytes != NULL);
+
+	transaction->bDone	= FALSE;
+	transaction->bError	= FALSE;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (__nQueueLength < __QUEUE_SIZE) {
+			u8 nTail = __nQueueHead + __nQueueLength;
+
+			if (nTail >= __QUEUE_SIZE) {
+				nTail -= __QUEUE_SIZE;
+			}
+
+			__queue[nTail] = transaction;
+
+			/*!
+			 *	Bus ist frei: START-Kondition erzeugen.
+			 *	Während __complete läuft wird die Transaktion
+			 *	von dort aus gestartet.
+			 */
+			if (++__nQueueLength == 1 && __bCompleting == FALSE) {
+				// Allfällige STOP-Kondition abwarten
+				while (BIT_ISSET(TWCR, TWSTO));
+
+				__nIndex	= 0;
+				TWCR		= __FLAGS_IE | _BV(TWSTA);
+			}
+
+			bSubmitted = TRUE;
+		}
+	}
+
+	return bSubmitted;
+}
+
+/*!
+ *	@function	TWI__isBusy
+ */
+bool TWI__isBusy(void) {
+	return (__nQueueLength > 0);
+}
+
 /*!
  *	@function	TWI__start
  */
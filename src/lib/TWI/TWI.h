@@ -24,6 +24,24 @@
  *	STOP-Kondition generieren:
  *	TWI__stop();
  *
+ *	Alternativ kann eine ganze Transaktion mit `TWI__submit`
+ *	übergeben werden. Diese wird im Hintergrund von der
+ *	TWI_vect ISR abgearbeitet, das Hauptprogramm läuft weiter.
+ *	Die blockierenden Funktionen dürfen nicht verwendet werden
+ *	solange `TWI__isBusy` 'TRUE' zurückgibt.
+ *
+ *	Beispiel:
+ *	Ein Byte schreiben und danach vier Bytes lesen:
+ *	transaction.nAddr		= 0b10101010;
+ *	transaction.nWriteBytes	= nWrite;
+ *	transaction.nNumWrite	= 1;
+ *	transaction.nReadBytes	= nRead;
+ *	transaction.nNumRead	= 4;
+ *	transaction.callbackFNC	= NULL;
+ *	TWI__submit(&transaction);
+ *	Prüfen ob Transaktion fertig:
+ *	transaction.bDone;
+ *
  *	@author		Marco Agnoli
  *	@copyright	2016 <Marco Agnoli>
  *	@date		11.05.2016
@@ -53,6 +71,33 @@
 	#define TWI_STATUS__WRITE_ACK		0x28
 	#define TWI_STATUS__WRITE_NACK		0x30
 
+	struct TWI__transaction;
+
+	typedef void (*TWI__callbackFNC_t)(struct TWI__transaction *transaction);
+
+	/*!
+	 *	Beschreibung einer I2C Transaktion:
+	 *	START, Bytes schreiben, REPEATED-START, Bytes lesen, STOP
+	 */
+	struct TWI__transaction {
+		// Adresse des Slaves (R/W Bit wird gesetzt)
+		u8							nAddr;
+		// Bytes die geschrieben werden
+		const u8					*nWriteBytes;
+		u8							nNumWrite;
+		// Puffer für die gelesenen Bytes
+		u8							*nReadBytes;
+		u8							nNumRead;
+		// Funktion die nach Abschluss in der ISR aufgerufen wird (optional)
+		TWI__callbackFNC_t			callbackFNC;
+		// Flag ob Transaktion abgeschlossen wurde
+		volatile bool				bDone;
+		// Flag ob ein Fehler aufgetreten ist (z.B. NACK)
+		volatile bool				bError;
+	};
+
+	typedef		struct TWI__transaction		TWI__transaction_t;
+
 	/*!
 	 *	@function	TWI__start
 	 *	@brief
@@ -154,4 +199,40 @@
 	 */
 	void TWI__stop(void);
 
+	/*!
+	 *	@function	TWI__submit
+	 *	@brief
+	 *	Reiht eine Transaktion in die Warteschlange ein.
+	 *	Die Transaktion wird von der ISR abgearbeitet,
+	 *	danach wird `bDone` gesetzt.
+	 *
+	 *	@param		transaction
+	 *	Beschreibung der Transaktion. Muss gültig bleiben
+	 *	bis `bDone` gesetzt wurde.
+	 *
+	 *	@return		bool
+	 *	'TRUE' wenn die Transaktion eingereiht wurde,
+	 *	'FALSE' wenn die Warteschlange voll ist.
+	 *
+	 *	@warning
+	 *		- Interrupte müssen aktiviert sein!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool TWI__submit(TWI__transaction_t *transaction);
+
+	/*!
+	 *	@function	TWI__isBusy
+	 *	@brief
+	 *	Gibt an ob noch Transaktionen abgearbeitet werden.
+	 *
+	 *	@return		bool
+	 *	'TRUE' wenn Transaktionen ausstehend, ansonsten 'FALSE'.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	bool TWI__isBusy(void);
+
 #endif // !defined(JAQ_TWI_H)
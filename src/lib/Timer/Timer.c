@@ -7,83 +7,233 @@
 #include <Timer/Timer.h>
 
 // Statische Definitionen --------------------------------
-// Anzahl Überlaufe
-static volatile u8 __nOverflows		= 0;
-// Gibt an ob Stoppuhr abgelaufen ist
-static volatile u8 __bHasExpired	= 1;
+#define __MAX_TIMERS	TIMER_MAX_TIMERS
+
+// Systemzeit in Millisekunden
+static volatile u16 __nTicks			= 0;
+// Anzahl angelegte Zeitgeber
+static Timer__ID_t __nTimers			= 0;
+// Ablaufzeitpunkte der Zeitgeber
+static u16 __nDeadlines[__MAX_TIMERS];
+// Bit n gesetzt: Zeitgeber n ist abgelaufen
+static volatile u8 __nExpired[(__MAX_TIMERS + 7u) / 8u];
+// Periode der periodischen Zeitgeber (0 = einmalig)
+static u16 __nPeriods[__MAX_TIMERS];
+// Funktion die beim Ablaufen in der ISR aufgerufen wird (optional)
+static Timer__callbackFNC_t __callbacks[__MAX_TIMERS];
+
+/*!
+ *	Nach Ablaufzeitpunkt sortierte Liste der laufenden Zeitgeber.
+ *	Der Zeitgeber der als nächstes abläuft steht am Ende
+ *	der Liste, damit er ohne Verschieben entfernt werden kann.
+ */
+static volatile Timer__ID_t __nQueue[__MAX_TIMERS];
+static volatile u8 __nQueueLength		= 0;
+
+#define __HAS_EXPIRED(_timer)	BIT_ISSET(__nExpired[(_timer) >> 3], (_timer) & 7u)
+#define __SET_EXPIRED(_timer)	(__nExpired[(_timer) >> 3] |= _BV((_timer) & 7u))
+#define __CLEAR_EXPIRED(_timer)	(__nExpired[(_timer) >> 3] &= ~_BV((_timer) & 7u))
+
+static INLINE bool __isBefore(u16 nDeadline1, u16 nDeadline2) {
+	// Differenz vorzeichenbehaftet auswerten wegen Überlauf von `__nTicks`
+	return ((i16)(nDeadline1 - nDeadline2) < 0);
+}
+
+/*!
+ *	Entfernt den Zeitgeber `nTimer` aus der Liste.
+ *	Muss atomar aufgerufen werden.
+ */
+static void __remove(Timer__ID_t nTimer) {
+	u8 nI = 0;
+
+	while (nI < __nQueueLength && __nQueue[nI] != nTimer) {
+		++nI;
+	}
+
+	ASSERT(nI < __nQueueLength);
+
+	for (--__nQueueLength; nI < __nQueueLength; ++nI) {
+		__nQueue[nI] = __nQueue[nI + 1];
+	}
+}
+
+/*!
+ *	Fügt den Zeitgeber `nTimer` sortiert in die Liste ein.
+ *	Muss atomar aufgerufen werden.
+ */
+static void __insert(Timer__ID_t nTimer) {
+	u8 nI = __nQueueLength;
+
+	ASSERT(__nQueueLength < __MAX_TIMERS);
+
+	// Früher ablaufende Zeitgeber nach hinten verschieben
+	while (nI > 0 && __isBefore(__nDeadlines[__nQueue[nI - 1]], __nDeadlines[nTimer])) {
+		__nQueue[nI] = __nQueue[nI - 1];
+		--nI;
+	}
+
+	__nQueue[nI] = nTimer;
+
+	++__nQueueLength;
+}
+
+static void __start(Timer__ID_t nTimer, u16 nTime, u16 nPeriod) {
+	INTERRUPTS_REQUIRED();
+	ASSERT(nTimer < __nTimers);
+	ASSERT(nTime > 0 && nTime < 0x8000u);
+
+	// Der Timer2 muss laufen
+	ASSERT(TCCR2 != 0);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		// Zeitgeber neu starten falls er noch läuft
+		if (__HAS_EXPIRED(nTimer) == FALSE) {
+			__remove(nTimer);
+		}
+
+		__nDeadlines[nTimer]	= __nTicks + nTime;
+		__nPeriods[nTimer]		= nPeriod;
+		__CLEAR_EXPIRED(nTimer);
+
+		__insert(nTimer);
+	}
+}
 // Statische Definitionen --------------------------------
 
 /*
  *	Interruptserviceroute für den Timer2.
- *	Ein LSB entspricht 64 Mikrosekunden.
- *	Ein Überlauf entspricht circa 16 Millisekunden. (64us*255)
+ *	Wird jede Millisekunde aufgerufen. (CTC, Prescaler 64, OCR2 = 249)
+ *	Es muss jeweils nur der Zeitgeber am Ende der Liste
+ *	geprüft werden.
+ *	Periodische Zeitgeber werden mit dem nächsten
+ *	Ablaufzeitpunkt wieder eingefügt.
  */
-ISR(TIMER2_OVF_vect, ISR_BLOCK) {
-	// Stoppuhr muss noch nicht abgelaufen sein
-	ASSERT(__bHasExpired == 0);
-	// Anzahl übrige Überläufe prüfen
-	ASSERT(__nOverflows > 0);
+ISR(TIMER2_COMP_vect, ISR_BLOCK) {
+	u16 nTicks = ++__nTicks;
 
-	if (--__nOverflows == 0) {
-		// Stoppuhr ist abgelaufen
-		__bHasExpired = 1;
+	while (__nQueueLength > 0) {
+		Timer__ID_t nTimer = __nQueue[__nQueueLength - 1];
 
-		// Timer2 stoppen
-		TCCR2 = 0;
+		if (__isBefore(nTicks, __nDeadlines[nTimer])) {
+			break;
+		}
+
+		--__nQueueLength;
+
+		if (__nPeriods[nTimer] > 0) {
+			// Ohne Drift auf den nächsten Ablaufzeitpunkt setzen
+			__nDeadlines[nTimer] += __nPeriods[nTimer];
+
+			__insert(nTimer);
+		} else {
+			// Zeitgeber ist abgelaufen
+			__SET_EXPIRED(nTimer);
+		}
 
-		// Overflow Interrupt für Timer2 deaktivieren
-		TIMSK &= ~_BV(TOIE2);
+		if (__callbacks[nTimer] != NULL) {
+			__callbacks[nTimer](nTimer);
+		}
 	}
 }
 
 /*!
- *	@function	Timer__start
+ *	@function	Timer__enable
  */
-void Timer__start(u8 nTime) {
-	INTERRUPTS_REQUIRED();
-	ASSERT(nTime > 16.32);
+void Timer__enable(void) {
+	// Timer2 stoppen
+	TCCR2 = 0;
 
-	// Die Stoppuhr muss abgelaufen sein
-	ASSERT(__nOverflows == 0 && __bHasExpired == 1);
+	TCNT2 = 0;
+	OCR2  = 249;
 
-	// Der Timer2 muss gestoppt sein
-	ASSERT(TCCR2 == 0);
+	// Compare Match Interrupt für Timer2 aktivieren
+	TIFR   = _BV(OCF2);
+	TIMSK |= _BV(OCIE2);
+
+	// Timer2 im CTC Modus mit Prescaler 64 starten
+	TCCR2 = _BV(WGM21) | _BV(CS22);
+}
 
-	// Overflow Interrupt für Timer2 deaktivieren
-	TIMSK &= ~_BV(TOIE2);
+/*!
+ *	@function	Timer__create
+ */
+Timer__ID_t Timer__create(void) {
+	Timer__ID_t nNewID = __nTimers;
 
-	{
-		// Anzahl Überläufe berechnen
-		u8 nOverflows = nTime / 16.32;
+	ASSERT(__nTimers < __MAX_TIMERS);
 
-		// Da nur vielfachen von 16.32ms verwendet werden können
-		// soll bei einem Überlauf von 0 das Programm abgebrochen werden.
-		ASSERT(nOverflows > 0);
+	__nPeriods[nNewID]		= 0;
+	__callbacks[nNewID]		= NULL;
 
-		// ATOMIC_BLOCK ist theoretisch nicht notwendig
-		// da Variablen 8 Bit breit sind.
-		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-			// Zähler Timer2 zurücksetzen
-			TCNT2			= 0;
-			// Anzahl Überläufe kopieren
-			__nOverflows	= nOverflows;
-		}
+	// Andere Bits werden in der ISR geändert
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__SET_EXPIRED(nNewID);
 	}
 
-	__bHasExpired = 0;
+	++__nTimers;
 
-	// Overflow Interrupt für Timer2 aktivieren
-	TIMSK |= _BV(TOIE2);
+	return nNewID;
+}
 
-	// Timer2 mit Prescaler 1024 starten
-	TCCR2 = _BV(CS22) | _BV(CS21) | _BV(CS20);
+/*!
+ *	@function	Timer__start
+ */
+void Timer__start(Timer__ID_t nTimer, u16 nTime) {
+	__start(nTimer, nTime, 0);
+}
+
+/*!
+ *	@function	Timer__startPeriodic
+ */
+void Timer__startPeriodic(Timer__ID_t nTimer, u16 nPeriod) {
+	__start(nTimer, nPeriod, nPeriod);
+}
+
+/*!
+ *	@function	Timer__setCallback
+ */
+void Timer__setCallback(Timer__ID_t nTimer, Timer__callbackFNC_t callbackFNC) {
+	ASSERT(nTimer < __nTimers);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		__callbacks[nTimer] = callbackFNC;
+	}
+}
+
+/*!
+ *	@function	Timer__stop
+ */
+void Timer__stop(Timer__ID_t nTimer) {
+	ASSERT(nTimer < __nTimers);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (__HAS_EXPIRED(nTimer) == FALSE) {
+			__remove(nTimer);
+
+			__SET_EXPIRED(nTimer);
+		}
+	}
 }
 
 /*!
  *	@function	Timer__hasExpired
  */
-bool Timer__hasExpired(void) {
+bool Timer__hasExpired(Timer__ID_t nTimer) {
 	INTERRUPTS_REQUIRED();
+	ASSERT(nTimer < __nTimers);
+
+	return __HAS_EXPIRED(nTimer);
+}
+
+/*!
+ *	@function	Timer__getTicks
+ */
+u16 Timer__getTicks(void) {
+	u16 nTicks;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		nTicks = __nTicks;
+	}
 
-	return (__bHasExpired == 1);
+	return nTicks;
 }
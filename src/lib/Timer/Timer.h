@@ -2,10 +2,27 @@
  *	@file		Timer.h
  *	@brief
  *	Hilfsmodul um Zeit abzählen zu können.
- *	`Timer__start` startet den Zähler.
+ *	Der Timer2 erzeugt einen Takt von einer Millisekunde.
+ *	Darauf aufbauend können mehrere Zeitgeber gleichzeitig
+ *	laufen, welche nach Ablaufzeitpunkt sortiert verwaltet werden.
+ *	`Timer__create` legt einen Zeitgeber an.
+ *	`Timer__start` startet den Zeitgeber.
  *	`Timer__hasExpired` prüft ob die angegebene Zeit
  *	verstrichen wurde.
  *
+ *	Beispiel:
+ *	Zeitgeber anlegen:
+ *	nTimer = Timer__create();
+ *	50ms abzählen:
+ *	Timer__start(nTimer, 50);
+ *	Prüfen ob abgelaufen:
+ *	Timer__hasExpired(nTimer);
+ *
+ *	Periodische Zeitgeber (`Timer__startPeriodic`) laufen
+ *	bis sie gestoppt werden. Mit `Timer__setCallback` kann
+ *	eine Funktion angegeben werden, welche bei jedem
+ *	Ablaufen direkt in der ISR aufgerufen wird.
+ *
  *	@author		Marco Agnoli
  *	@copyright	2016 <Marco Agnoli>
  *	@date		11.05.2016
@@ -16,39 +33,154 @@
 
 	#include <common/common.h>
 
+	/*!
+	 *	Maximale Anzahl Zeitgeber. Zurzeit sind alle belegt:
+	 *		- Measure: einer pro Messaufgabe (measurements.c: 3)
+	 *		- LCD: Warteschlange
+	 *		- FreqCounter: Torzeit
+	 *		- SigGen: Frequenzdurchlauf
+	 *		- Input: Tasten abtasten
+	 *		- Relay: Schaltfolgen
+	 *	Ein weiterer Zeitgeber braucht einen höheren Wert
+	 *	(gut 7 Bytes SRAM pro Zeitgeber).
+	 */
+	#define TIMER_MAX_TIMERS	8u
+
+	typedef u8 Timer__ID_t;
+
+	typedef void (*Timer__callbackFNC_t)(Timer__ID_t nTimer);
+
+	/*!
+	 *	@function	Timer__enable
+	 *	@brief
+	 *	Startet den Millisekundentakt auf dem Timer2.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Timer__enable(void);
+
+	/*!
+	 *	@function	Timer__create
+	 *	@brief
+	 *	Legt einen neuen Zeitgeber an.
+	 *
+	 *	@return		Timer__ID_t
+	 *	ID für den Zeitgeber.
+	 *
+	 *	@warning
+	 *		- Höchstens TIMER_MAX_TIMERS Zeitgeber (ASSERT)!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	Timer__ID_t Timer__create(void);
+
 	/*!
 	 *	@function	Timer__start
 	 *	@brief
 	 *	Fängt an die Zeit `nTime` (in Millisekunden) abzuzählen.
+	 *	Läuft der Zeitgeber noch, wird er neu gestartet.
 	 *
-	 *	@param		nTime		Zeitperiode in Millisekunden.
+	 *	@param		nTimer		ID des Zeitgebers.
+	 *	@param		nTime		Zeitperiode in Millisekunden (1 bis 32767).
 	 *
 	 *	@warning
-	 *		- Es sind nur vielfache von 16.35ms einstellbar!
+	 *		- Timer__enable muss vorher aufgerufen worden sein!
+	 *		- Interrupte müssen aktiviert sein (INTERRUPTS_REQUIRED),
+	 *		  ein Aufruf aus einer Callback-Funktion (ISR) führt
+	 *		  (mit DEBUG) zu PANIC!
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	void Timer__start(u8 nTime);
+	void Timer__start(Timer__ID_t nTimer, u16 nTime);
+
+	/*!
+	 *	@function	Timer__startPeriodic
+	 *	@brief
+	 *	Startet den Zeitgeber periodisch. Er läuft alle `nPeriod`
+	 *	Millisekunden ab, ohne dass sich Verzögerungen aufsummieren.
+	 *	`Timer__hasExpired` gibt erst nach `Timer__stop` 'TRUE' zurück.
+	 *
+	 *	@param		nTimer		ID des Zeitgebers.
+	 *	@param		nPeriod		Periode in Millisekunden (1 bis 32767).
+	 *
+	 *	@warning
+	 *		- Timer__enable muss vorher aufgerufen worden sein!
+	 *		- Wie Timer__start nicht aus einer Callback-Funktion aufrufen!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Timer__startPeriodic(Timer__ID_t nTimer, u16 nPeriod);
+
+	/*!
+	 *	@function	Timer__setCallback
+	 *	@brief
+	 *	Setzt eine Funktion, welche bei jedem Ablaufen des
+	 *	Zeitgebers in der ISR aufgerufen wird.
+	 *	Die Funktion darf `Timer__stop` aufrufen,
+	 *	aber nicht `Timer__start` bzw. `Timer__startPeriodic`.
+	 *
+	 *	@param		nTimer		ID des Zeitgebers.
+	 *	@param		callbackFNC	Funktion oder 'NULL'.
+	 *
+	 *	@warning
+	 *		- Die Funktion läuft mit deaktivierten Interrupten
+	 *		  und muss kurz sein!
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Timer__setCallback(Timer__ID_t nTimer, Timer__callbackFNC_t callbackFNC);
+
+	/*!
+	 *	@function	Timer__stop
+	 *	@brief
+	 *	Stoppt den Zeitgeber. Er gilt danach als abgelaufen.
+	 *
+	 *	@param		nTimer		ID des Zeitgebers.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Timer__stop(Timer__ID_t nTimer);
 
 	/*!
 	 *	@function	Timer__hasExpired
 	 *	@brief
 	 *	Prüft ob die angebene Zeit verstrichen wurde.
 	 *
+	 *	@param		nTimer		ID des Zeitgebers.
+	 *
 	 *	@return		bool
 	 *	'TRUE' falls Timer abgelaufen, ansonsten 'FALSE'.
 	 *
 	 *	@warning
-	 *		- StopWatch__start muss vorher aufgerufen worden sein.
+	 *		- Timer__start muss vorher aufgerufen worden sein.
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	bool Timer__hasExpired(void);
+	bool Timer__hasExpired(Timer__ID_t nTimer);
+
+	/*!
+	 *	@function	Timer__getTicks
+	 *	@brief
+	 *	Gibt die Systemzeit in Millisekunden zurück.
+	 *	Der Wert läuft nach 65.535 Sekunden über.
+	 *
+	 *	@return		u16
+	 *	Systemzeit in Millisekunden.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	u16 Timer__getTicks(void);
 
 #endif // !defined(JAQ_TIMER_H)
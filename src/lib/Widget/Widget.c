@@ -0,0 +1,202 @@
+/*!
+ *	@file		Widget.c
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#include <Widget/Widget.h>
+#include <LCD/LCD.h>	// LCD__*
+
+// Statische Definitionen --------------------------------
+// Pixelspalten und -zeilen pro Zelle
+#define __COLUMNS		5u
+#define __ROWS			8u
+
+// Zeichensätze im CGRAM
+#define __GLYPHS_NONE	0u
+#define __GLYPHS_BAR	1u
+#define __GLYPHS_TREND	2u
+
+static u8 __nGlyphs	= __GLYPHS_NONE;
+
+/*!
+ *	Schreibt den Zeichensatz `nGlyphs` ins CGRAM,
+ *	falls er nicht bereits geladen ist.
+ *	Balken: Code 0 bis 4 = 1 bis 5 Spalten von links.
+ *	Verlauf: Code 0 bis 7 = 1 bis 8 Zeilen von unten.
+ */
+static void __loadGlyphs(u8 nGlyphs) {
+	u8 nRows[__ROWS];
+
+	if (__nGlyphs == nGlyphs) return;
+
+	if (nGlyphs == __GLYPHS_BAR) {
+		for (u8 nI = 0; nI < __COLUMNS; ++nI) {
+			memset(nRows, (0x1F << (__COLUMNS - 1 - nI)) & 0x1F, sizeof(nRows));
+
+			LCD__defineGlyph(nI, nRows);
+		}
+	} else {
+		for (u8 nI = 0; nI < __ROWS; ++nI) {
+			for (u8 nRow = 0; nRow < __ROWS; ++nRow) {
+				nRows[nRow] = (nRow >= __ROWS - 1 - nI ? 0x1F : 0);
+			}
+
+			LCD__defineGlyph(nI, nRows);
+		}
+	}
+
+	__nGlyphs = nGlyphs;
+}
+
+/*!
+ *	Die Werte des Verlaufs werden als obere Hälfte eines
+ *	float gespeichert (Vorzeichen, Exponent, 7 Bit Mantisse).
+ *	Gerundet ist der Fehler höchstens 0.4% des Wertes. Das
+ *	ist weniger als eine Stufe der Anzeige, solange der
+ *	angezeigte Bereich grösser als 6% des Wertes ist.
+ */
+union __trendValue {
+	float	dValue;
+	u32		nBits;
+};
+
+static u16 __pack(ldbl dValue) {
+	union __trendValue value;
+
+	value.dValue = dValue;
+
+	return (value.nBits + 0x8000ul) >> 16;
+}
+
+static ldbl __unpack(u16 nValue) {
+	union __trendValue value;
+
+	value.nBits = (u32)nValue << 16;
+
+	return value.dValue;
+}
+
+/*!
+ *	Bildet `dValue` auf 0 bis `nSteps` ab.
+ */
+static u8 __scale(ldbl dValue, ldbl dMin, ldbl dMax, u8 nSteps) {
+	if (!(dValue > dMin)) return 0;
+	if (dValue >= dMax) return nSteps;
+
+	return (u8)((dValue - dMin) / (dMax - dMin) * nSteps + 0.5L);
+}
+// Statische Definitionen --------------------------------
+
+/*!
+ *	@function	Widget__drawBar
+ */
+void Widget__drawBar(u8 nX, u8 nY, u8 nWidth, ldbl dValue, ldbl dMin, ldbl dMax) {
+	u8 nPixels;
+
+	ASSERT(nWidth > 0 && nWidth <= 16 && dMin < dMax);
+
+	__loadGlyphs(__GLYPHS_BAR);
+
+	nPixels = __scale(dValue, dMin, dMax, nWidth * __COLUMNS);
+
+	LCD__gotoXY(nX, nY);
+
+	for (u8 nI = 0; nI < nWidth; ++nI) {
+		if (nPixels >= __COLUMNS) {
+			LCD__putc(__COLUMNS - 1);
+			nPixels -= __COLUMNS;
+		} else if (nPixels > 0) {
+			LCD__putc(nPixels - 1);
+			nPixels = 0;
+		} else {
+			LCD__putc(' ');
+		}
+	}
+}
+
+/*!
+ *	@function	Widget__resetTrend
+ */
+void Widget__resetTrend(Widget__trend_t *trend) {
+	ASSERT(trend != NULL);
+
+	trend->nHead	= 0;
+	trend->nCount	= 0;
+}
+
+/*!
+ *	@function	Widget__addTrend
+ */
+void Widget__addTrend(Widget__trend_t *trend, ldbl dValue) {
+	ASSERT(trend != NULL);
+
+	// NAN ist ungleich sich selbst
+	if (dValue != dValue) return;
+
+	trend->nValues[trend->nHead] = __pack(dValue);
+
+	if (++trend->nHead == WIDGET_TREND_LENGTH) {
+		trend->nHead = 0;
+	}
+
+	if (trend->nCount < WIDGET_TREND_LENGTH) {
+		++trend->nCount;
+	}
+}
+
+/*!
+ *	@function	Widget__drawTrend
+ */
+void Widget__drawTrend(const Widget__trend_t *trend, u8 nX, u8 nY, u8 nWidth, ldbl dMin, ldbl dMax) {
+	u8 nCount;
+	u8 nIndex;
+
+	ASSERT(trend != NULL);
+	ASSERT(nWidth > 0 && nWidth <= WIDGET_TREND_LENGTH);
+
+	__loadGlyphs(__GLYPHS_TREND);
+
+	nCount = (trend->nCount < nWidth ? trend->nCount : nWidth);
+
+	// Ältester angezeigter Wert
+	nIndex = trend->nHead + WIDGET_TREND_LENGTH - nCount;
+
+	if (nIndex >= WIDGET_TREND_LENGTH) {
+		nIndex -= WIDGET_TREND_LENGTH;
+	}
+
+	// Bereich aus den angezeigten Werten bestimmen
+	if (!(dMin < dMax) && nCount > 0) {
+		u8 nI = nIndex;
+
+		dMin = dMax = __unpack(trend->nValues[nI]);
+
+		for (u8 nJ = 1; nJ < nCount; ++nJ) {
+			if (++nI == WIDGET_TREND_LENGTH) nI = 0;
+
+			ldbl dValue = __unpack(trend->nValues[nI]);
+
+			if (dValue < dMin) dMin = dValue;
+			if (dValue > dMax) dMax = dValue;
+		}
+	}
+
+	LCD__gotoXY(nX, nY);
+
+	// Fehlende Werte links leer lassen
+	for (u8 nI = nCount; nI < nWidth; ++nI) {
+		LCD__putc(' ');
+	}
+
+	for (u8 nI = 0; nI < nCount; ++nI) {
+		// Konstanter Verlauf in der Mitte
+		u8 nLevel = (dMin < dMax ? __scale(__unpack(trend->nValues[nIndex]), dMin, dMax, __ROWS - 1) : __ROWS / 2 - 1);
+
+		LCD__putc(nLevel);
+
+		if (++nIndex == WIDGET_TREND_LENGTH) {
+			nIndex = 0;
+		}
+	}
+}
@@ -0,0 +1,116 @@
+/*!
+ *	@file		Widget.h
+ *	@brief
+ *	Grafische Anzeigen für das LC-Display aus frei definierbaren
+ *	Zeichen (CGRAM):
+ *		- Balken mit einer Auflösung von einer Pixelspalte
+ *		  (fünf pro Zelle).
+ *		- Verlauf (Sparkline) mit acht Stufen pro Zelle.
+ *
+ *	Die Widgets schreiben in den Bildspeicher des LCD Moduls.
+ *	LCD__update überträgt danach nur die Zellen, deren
+ *	Zeichen sich geändert hat.
+ *
+ *	Beispiel:
+ *	Balken für 4-20mA über die ganze Zeile:
+ *	Widget__drawBar(0, 1, 16, dCurrent, 4E-3, 20E-3);
+ *	Verlauf:
+ *	Widget__addTrend(&trend, dValue);
+ *	Widget__drawTrend(&trend, 0, 1, 16, 0, 0);
+ *
+ *	@warning
+ *		- Balken und Verlauf verwenden unterschiedliche Zeichensätze,
+ *		  es kann jeweils nur eine Art gleichzeitig angezeigt werden.
+ *		  Beim Wechsel wird das CGRAM neu beschrieben.
+ *
+ *	@author		Marco Agnoli
+ *	@copyright	2016 <Marco Agnoli>
+ */
+#if !defined(JAQ_WIDGET_H)
+	#define JAQ_WIDGET_H 1
+
+	#include <common/common.h>
+
+	// Maximale Anzahl Werte im Verlauf (eine Zeile)
+	#define WIDGET_TREND_LENGTH		16u
+
+	/*!
+	 *	Verlauf eines Messwertes, der neueste Wert
+	 *	wird ganz rechts angezeigt.
+	 */
+	struct Widget__trend {
+		// Obere Hälfte eines float, 2 Byte pro Wert (siehe Widget.c)
+		u16		nValues[WIDGET_TREND_LENGTH];
+		// Nächste Schreibposition
+		u8		nHead;
+		// Anzahl gültige Werte
+		u8		nCount;
+	};
+
+	typedef		struct Widget__trend	Widget__trend_t;
+
+	/*!
+	 *	@function	Widget__drawBar
+	 *	@brief
+	 *	Zeichnet einen horizontalen Balken ab (`nX`, `nY`)
+	 *	über `nWidth` Zellen. Der Balken ist leer bei `dMin`
+	 *	und voll bei `dMax`, Werte ausserhalb werden begrenzt.
+	 *
+	 *	@param		nX			Erste Spalte.
+	 *	@param		nY			Zeile.
+	 *	@param		nWidth		Breite in Zellen.
+	 *	@param		dValue		Anzuzeigender Wert.
+	 *	@param		dMin		Wert für leeren Balken.
+	 *	@param		dMax		Wert für vollen Balken.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Widget__drawBar(u8 nX, u8 nY, u8 nWidth, ldbl dValue, ldbl dMin, ldbl dMax);
+
+	/*!
+	 *	@function	Widget__resetTrend
+	 *	@brief
+	 *	Löscht alle Werte des Verlaufs `trend`.
+	 *
+	 *	@param		trend		Verlauf.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Widget__resetTrend(Widget__trend_t *trend);
+
+	/*!
+	 *	@function	Widget__addTrend
+	 *	@brief
+	 *	Fügt den Wert `dValue` zum Verlauf hinzu, der älteste
+	 *	Wert fällt heraus. Ungültige Werte (NAN) werden ignoriert.
+	 *
+	 *	@param		trend		Verlauf.
+	 *	@param		dValue		Neuer Wert.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Widget__addTrend(Widget__trend_t *trend, ldbl dValue);
+
+	/*!
+	 *	@function	Widget__drawTrend
+	 *	@brief
+	 *	Zeichnet die neuesten `nWidth` Werte des Verlaufs ab
+	 *	(`nX`, `nY`), ein Wert pro Zelle. Ist `dMin` nicht kleiner
+	 *	als `dMax`, wird der Bereich aus den Werten bestimmt.
+	 *
+	 *	@param		trend		Verlauf.
+	 *	@param		nX			Erste Spalte.
+	 *	@param		nY			Zeile.
+	 *	@param		nWidth		Breite in Zellen (max. WIDGET_TREND_LENGTH).
+	 *	@param		dMin		Wert der untersten Stufe.
+	 *	@param		dMax		Wert der obersten Stufe.
+	 *
+	 *	@author		Marco Agnoli
+	 *	@copyright	2016 <Marco Agnoli>
+	 */
+	void Widget__drawTrend(const Widget__trend_t *trend, u8 nX, u8 nY, u8 nWidth, ldbl dMin, ldbl dMax);
+
+#endif // !defined(JAQ_WIDGET_H)
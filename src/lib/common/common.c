@@ -15,16 +15,21 @@ void throw(const char *sFile, u32 nLine, const char *sMsg, ...) {
 	DISABLE_INTERRUPTS();
 
 	char sMessage[16];
+	const char *sName = strrchr_P(sFile, '/');
 	va_list ap;
 
 	memset(sMessage, 0, sizeof(sMessage));
-	va_start(ap, sMsg);
-	vsnprintf(sMessage, sizeof(sMessage), sMsg, ap);
-	va_end(ap);
-	
+
+	if (sMsg != NULL) {
+		va_start(ap, sMsg);
+		vsnprintf_P(sMessage, sizeof(sMessage), sMsg, ap);
+		va_end(ap);
+	}
+
 	LCD__init();
 	LCD__clearScreen();
-	LCD__print("%-10s\nLine: %4" PRIu32, sFile, nLine);
+	LCD__print_P(PSTR("%-10S\nLine: %4" PRIu32), (sName ? sName + 1 : sFile), nLine);
+	LCD__update();
 
 	for (;;);
 }
@@ -21,6 +21,7 @@
 	#include	<stdio.h>			// *snprintf
 	#include	<inttypes.h>		// PRI*n
 	#include	<string.h>			// strrchr
+	#include	<avr/pgmspace.h>	// PROGMEM, PSTR
 	#include	<math.h>			// NAN
 
 	typedef		uint8_t		u8;
@@ -56,19 +57,24 @@
 	 *	@function	throw
 	 *	@brief
 	 *	Bricht das Programm ab und gibt eine Fehlermeldung aus.
+	 *	Dateiname und Meldung liegen im Flash, `sMsg` ist bei
+	 *	ASSERT 'NULL'.
 	 *
 	 *	@author		Marco Agnoli
 	 *	@copyright	2016 <Marco Agnoli>
 	 *	@date		11.05.2016
 	 *	@version	1.0.0
 	 */
-	NORETURN void throw(const char *sFile, u32 nLine, const char *sMsg, ...) FORMAT(3, 4);
+	NORETURN void throw(const char *sFile, u32 nLine, const char *sMsg, ...);
 
 	#define DEBUG 1
 
 	#if defined(DEBUG)
-		#define PANIC(_msg, ...)		throw((strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__), __LINE__, _msg, ##__VA_ARGS__)
-		#define ASSERT(_expr)			if (!(_expr)) { PANIC("ASSERT"); }
+		// Dateiname nur einmal pro Übersetzungseinheit im Flash
+		static const char __sFile[] PROGMEM UNUSED = __FILE__;
+
+		#define PANIC(_msg, ...)		throw(__sFile, __LINE__, PSTR(_msg), ##__VA_ARGS__)
+		#define ASSERT(_expr)			if (!(_expr)) { throw(__sFile, __LINE__, NULL); }
 		#define INTERRUPTS_REQUIRED()	ASSERT(BIT_ISSET(SREG, 7))
 	#else
 		#define PANIC(_msg, ...)
@@ -8,9 +8,9 @@
  *	ADC um diverese Messgrössen zu ermitteln (Spannung, Strom, Temperatur).
  *	Der externe Interrupt (INT2) in Kombination mit dem
  *	Timer0 (8 Bit) wird verwendet um die Frequenz eines Signales zu bestimmen.
- *	Der Timer2 (8 Bit) wird verwendet um die diversen Messgrössen innerhalb eines Zeitfensters
- *	zu messen. Mit dem Timer1 (16 Bit) wird ein Sensorsignal emuliert welches über das
- *	SigGen verändert werden kann.
+ *	Der Timer2 (8 Bit) erzeugt einen Millisekundentakt, mit dem die diversen Messgrössen
+ *	innerhalb ihrer eigenen Zeitfenster gemessen werden. Mit dem Timer1 (16 Bit) wird ein Sensorsignal emuliert welches über das
+ *	SigGen verändert werden kann (CTC Modus, Ausgang OC1A).
  *	
  *	Mikrokontroller		:	ATMega16a
  *	Fusebits			:	- Externer Quarz aktiviert
@@ -32,7 +32,7 @@
  *
  *	T400_NC				:	PB3 (?)
  *	T400_NO				:	PB1 (?)
- *	T400_COM			:	PD6
+ *	T400_COM			:	PD6 (ICP1, siehe InputCapture)
  *	T400_CRNT			:	ADC7
  *	T400_V+				:	ADC6
  *	T400_SIG			:	PD5
@@ -48,8 +48,14 @@
  */
 #include <common/common.h>				// common
 #include <LCD/LCD.h>					// LCD_*
+#include <Format/Format.h>				// Format_*
+#include <Widget/Widget.h>				// Widget_*
+#include <Relay/Relay.h>				// Relay_*
+#include <Input/Input.h>				// Input_*
 #include <SigGen/SigGen.h>				// SigGen_*
 #include <Watchdog/Watchdog.h>			// Watchdog_*
+#include <InputCapture/InputCapture.h>	// InputCapture_*
+#include <ExtADC/ExtADC.h>				// ExtADC_*
 #include <measurements.h>				// measurements
 
 // Statische Definitionen --------------------------------
@@ -60,67 +66,83 @@ static bool bWatchdogReset = FALSE;
 #define SW3 2
 #define SW4 4
 
-// Flankentriggerung der Taster
-static u8 nSW, nOldSW;
+// Zuletzt abgeholtes Tasterereignis
+static Input__event_t event;
+static bool bEvent = FALSE;
 
 // Auswahl Messwerte für obere und untere Zeile
 static u8 nTopIndex, nBotIndex;
 
+// Untere Zeile zeigt den Verlauf des oberen Messwertes
+#define DISPLAY_TREND	4
+// Untere Zeile zeigt Diagnosewerte der Treiber
+#define DISPLAY_DEBUG	5
+
+// Verlauf des oberen Messwertes
+static Widget__trend_t trend;
+
 // Messwerte
-static ldbl dReadings[5]	= {0, 0, 0, 0, 0};
+static ldbl dReadings[MEASUREMENTS_COUNT]	= {0, 0, 0, 0};
 
 // Flag ob Display aktualisiert werden sollte
 static bool bDisplayShouldUpdate = FALSE;
 
-static INLINE u8 readSwitches(void) {
-	return PIND & 0b00010111;
-}
-
-static INLINE void pulseRelay(u8 nRelayID) {
-	PORTA |= _BV(nRelayID);
-	// Warten bis Relais fertig
-	_delay_ms(25);
-	PORTA &= ~_BV(nRelayID);
-	// Warten bis Relais fertig (Sicherheitsmarge)
-	_delay_ms(25);
-}
-
 static INLINE bool readSwitch(u8 nSwitchID) {
-	return (!BIT_ISSET(nSW, nSwitchID) && BIT_ISSET(nOldSW, nSwitchID));
+	return (bEvent && event.nKey == nSwitchID && event.nType == InputPress);
 }
 
 static bool bFlip = FALSE;
-// Statische Definitionen --------------------------------
 
 /*!
- *	@function	resetRelays
- *	@brief
- *	Setzt beide Relais zurück (K1 & K2).
+ *	Gibt Bezeichnung und Messwert `nIndex` mit
+ *	SI-Präfix und Einheit aus, z.B. "Freq : 1.000kHz".
  */
-void resetRelays(void) {
-	pulseRelay(PA0);
-	pulseRelay(PA3);
+static void printReading(u8 nIndex) {
+	char sValue[12];
+
+	Format__SI(sValue, sizeof(sValue), dReadings[nIndex], 3, measurmentsUnits[nIndex]);
+
+	LCD__puts_P(measurmentsStrings[nIndex]);
+	LCD__puts_P(PSTR(" : "));
+	LCD__puts(sValue);
 }
 
 /*!
- *	@function	setRelayK1
- *	@brief
- *	Aktiviert Relais K1.
+ *	Gibt die I2C Bytes pro Messergebnis des externen ADC,
+ *	die von LCD__update eingesparten Buszyklen und den Gain
+ *	des analogen Ausgangs aus, z.B. "B3.0 S12.3k G8".
  */
-void setRelayK1(void) {
-	pulseRelay(PA3);
-	pulseRelay(PA1);
+static void printDebug(void) {
+	char sValue[8];
+
+	Format__SI(sValue, sizeof(sValue), ExtADC__getBytesPerSample(), 1, NULL);
+
+	LCD__putc('B');
+	LCD__puts(sValue);
+
+	Format__SI(sValue, sizeof(sValue), LCD__getSavedCycles(), 1, NULL);
+
+	LCD__puts_P(PSTR(" S"));
+	LCD__puts(sValue);
+
+	LCD__puts_P(PSTR(" G"));
+	LCD__putc('0' + (1 << getAnalogOutputGain()));
 }
 
 /*!
- *	@function	setRelayK2
- *	@brief
- *	Aktiviert Relais K2.
+ *	Holt den Messwert `nID` ab und ergänzt den Verlauf,
+ *	falls er in der oberen Zeile angezeigt wird.
  */
-void setRelayK2(void) {
-	pulseRelay(PA0);
-	pulseRelay(PA2);
+static bool acquireValue(Measure__MeasurementID_t nID) {
+	bool bNew = getMeasurement(nID, &dReadings[nID]);
+
+	if (bNew && nID == nTopIndex) {
+		Widget__addTrend(&trend, dReadings[nID]);
+	}
+
+	return bNew;
 }
+// Statische Definitionen --------------------------------
 
 /*!
  *	@function	acquireNewValues
@@ -135,28 +157,16 @@ bool acquireNewValues(void) {
 	u8 update = 0;
 
 	// Stromaufnahme T400
-	update |= getMeasurement(
-								MEASURE_T400_CURRENT,
-								&dReadings[MEASURE_T400_CURRENT]
-							 );
+	update |= acquireValue(MEASURE_T400_CURRENT);
 
 	// T400 Sensorversorgungsspannung
-	update |= getMeasurement(
-								MEASURE_T400_VSENSOR,
-								&dReadings[MEASURE_T400_VSENSOR]
-							 );
+	update |= acquireValue(MEASURE_T400_VSENSOR);
 
 	// T400 Openkollektorfrequenz
-	update |= getMeasurement(
-								MEASURE_T400_OCFREQUENCY,
-								&dReadings[MEASURE_T400_OCFREQUENCY]
-							 );
+	update |= acquireValue(MEASURE_T400_OCFREQUENCY);
 
 	// T400 Analoger Ausgang
-	update |= getMeasurement(
-								nMEASURE_T400_ANALOGOUTPUT,
-								&dReadings[nMEASURE_T400_ANALOGOUTPUT]
-							 );
+	update |= acquireValue(MEASURE_T400_ANALOGOUTPUT);
 
 	return update;
 }
@@ -164,10 +174,12 @@ bool acquireNewValues(void) {
 /*!
  *	@function	readInputs
  *	@brief
- *	Liest die Taster ein.
+ *	Holt das nächste Tasterereignis ab.
+ *	Die Taster werden vom Timer entprellt, es gehen
+ *	keine Ereignisse verloren.
  */
 void readInputs(void) {
-	nSW = readSwitches();
+	bEvent = Input__read(&event);
 }
 
 /*!
@@ -183,28 +195,21 @@ void processData(void) {
 
 	// Wechseln der Anzeige
 	if (readSwitch(SW1)) {
-		if (++nTopIndex == 4) nTopIndex = 0;
+		if (++nTopIndex == MEASUREMENTS_COUNT) nTopIndex = 0;
+
+		// Verlauf gehört zum bisherigen Messwert
+		Widget__resetTrend(&trend);
 
 		bDisplayShouldUpdate = TRUE;
 	} else if (readSwitch(SW2)) {
-		if (++nBotIndex == 4) nBotIndex = 0;
+		if (++nBotIndex > DISPLAY_DEBUG) nBotIndex = 0;
 
 		bDisplayShouldUpdate = TRUE;
 	} else if (readSwitch(SW3)) {
-		// TODO: über API
 		bFlip = !bFlip;
 
-		Watchdog__reset();
-		if (bFlip) {
-			resetRelays();
-			Watchdog__reset();
-			setRelayK1();
-		} else {
-			resetRelays();
-			Watchdog__reset();
-			setRelayK2();
-		}
-		Watchdog__reset();
+		// K1 und K2 abwechselnd setzen, das andere wird zurückgesetzt
+		Relay__set(bFlip ? RelayK1 : RelayK2);
 	} else if (readSwitch(SW4)) {
 		for (;;);
 	}
@@ -220,17 +225,73 @@ void output(void) {
 	if (bDisplayShouldUpdate) {
 		LCD__clearScreen();
 
-		// Ausgabe der Messwerte mit Beschreibung
-		// TODO: Messgrösse (Hz, mA) hinzufügen
-		LCD__print("%s : %3.3f\n%s : %3.3f", measurmentsStrings[nTopIndex], (double)dReadings[nTopIndex], measurmentsStrings[nBotIndex], (double)dReadings[nBotIndex]);
+		// Ausgabe der Messwerte mit Beschreibung und Einheit
+		printReading(nTopIndex);
+		LCD__putc('\n');
+
+		if (nBotIndex == DISPLAY_TREND) {
+			Widget__drawTrend(&trend, 0, 1, WIDGET_TREND_LENGTH, 0, 0);
+		} else if (nBotIndex == DISPLAY_DEBUG) {
+			printDebug();
+		} else {
+			printReading(nBotIndex);
+		}
+
+		// Nur geänderte Zeichen übertragen
+		LCD__update();
 
 		Watchdog__reset();
 	}
+}
+
+/*!
+ *	@function	checkRelayResponse
+ *	@brief
+ *	Misst die Ansprechzeit des T400 Relais bei Signalausfall
+ *	und zeigt sie zusammen mit der Prelldauer an.
+ */
+void checkRelayResponse(void) {
+	char sValue[12];
+	u32 nResponse, nBounce;
+
+	// T400 soll das Signal zuerst erkennen
+	_delay_ms(1000);
+
+	LCD__clearScreen();
+
+	if (measureRelayResponse(&nResponse, &nBounce)) {
+		Format__SI(sValue, sizeof(sValue), nResponse * 62.5E-9L, 2, "s");
+		LCD__print_P(PSTR("Relais %s\n"), sValue);
+
+		// Ungültige Werte (NAN) werden als "---" ausgegeben
+		Format__SI(sValue, sizeof(sValue), (nBounce == RELAY_BOUNCE_LOST ? NAN : nBounce * 62.5E-9L), 2, "s");
+		LCD__print_P(PSTR("Prellen %s"), sValue);
+	} else {
+		LCD__puts_P(PSTR("Relais schaltet\nnicht"));
+	}
+
+	LCD__update();
 
-	// Für Flankentriggerung
-	nOldSW = nSW;
+	_delay_ms(2000);
 }
 
+#if defined(LCD_BENCHMARK)
+/*!
+ *	@function	benchmarkLCD
+ *	@brief
+ *	Zeigt die mittleren Takte pro lcd_data an.
+ */
+void benchmarkLCD(void) {
+	u16 nCycles = LCD__benchmark(100);
+
+	LCD__clearLine(1);
+	LCD__print_P(PSTR("lcd_data %u clk"), nCycles);
+	LCD__update();
+
+	_delay_ms(3000);
+}
+#endif
+
 void checkWatchdog(void) {
 	if (bWatchdogReset) {
 		u8 nNum				= 0;
@@ -239,7 +300,8 @@ void checkWatchdog(void) {
 
 		bSW1 = bSW2 = bSW3 = bSW4 = FALSE;
 
-		LCD__print("Watchdog reset!");
+		LCD__puts_P(PSTR("Watchdog reset!"));
+		LCD__update();
 
 		/*!
 		 *	Falls der Watchdog den Mikrokontroller
@@ -249,7 +311,7 @@ void checkWatchdog(void) {
 		 *	einmal gedrückt werden (SW1 bis SW4).
 		 */
 		do {
-			nSW = readSwitches();
+			readInputs();
 
 			if (readSwitch(SW1) && !bSW1) {
 				bSW1 = TRUE;
@@ -270,17 +332,16 @@ void checkWatchdog(void) {
 
 				LCD__clearLine(1);
 
-				LCD__print("%c%c%c%c",
+				LCD__print_P(PSTR("%c%c%c%c"),
 					(bSW1 ? 'X' : ' '),
 					(bSW2 ? 'X' : ' '),
 					(bSW3 ? 'X' : ' '),
 					(bSW4 ? 'X' : ' ')
 				);
+				LCD__update();
 
 				 ++nNum;
 			}
-
-			nOldSW = nSW;
 		} while (nNum < 4);
 	}
 }
@@ -296,7 +357,12 @@ void init(void) {
 	LCD__init();
 	LCD__clearScreen();
 
-	LCD__print("T400 %s\n%s", "Pruefsystem", "IPA Marco A.");
+	LCD__puts_P(PSTR("T400 Pruefsystem\nIPA Marco A."));
+	LCD__update();
+
+#if defined(LCD_BENCHMARK)
+	benchmarkLCD();
+#endif
 
 	DDRD 	= 0b000100000;
 	PORTD	= 0b000000000;
@@ -304,35 +370,57 @@ void init(void) {
 	DDRA	= 0b000011111;
 	PORTA	= 0b000000000;
 
-	resetRelays();
-
 	_delay_ms(1000);
 
-	nSW		= readSwitches();
-	nOldSW	= nSW;
-
 	ENABLE_INTERRUPTS();
 	initMeasurements();
+
+	// Relais in einen bekannten Zustand bringen
+	Relay__enable();
+	Relay__resetAll();
+
+	// Taster SW1 bis SW4 entprellt abtasten
+	Input__enable(_BV(SW1) | _BV(SW2) | _BV(SW3) | _BV(SW4));
+
+	// Ab hier blockiert die Ausgabe am LC-Display nicht mehr
+	LCD__enableQueue();
+
 	SigGen__enable();
+	InputCapture__enable();
+
+	/*!
+	 *	Frequenzzähler über Rückführung des SigGen kalibrieren.
+	 *	Gespeichert wird nur, wenn der Bediener die Rückführung
+	 *	mit SW2 beim Einschalten bestätigt.
+	 */
+	calibrateFreqCounter((PIND & _BV(SW2)) == 0);
 
 	nTopIndex = 0;
 	nBotIndex = 0;
 
+	Widget__resetTrend(&trend);
+
 	LCD__clearScreen();
+	LCD__update();
 
+	// Relaistest, läuft im Hintergrund ab
 	if ((PIND & _BV(SW1)) == 0) {
-		_delay_ms(500);
-		setRelayK1();
-		_delay_ms(500);
-		resetRelays();
-		setRelayK2();
-		_delay_ms(500);
-		resetRelays();
+		Relay__delay(500);
+		Relay__set(RelayK1);
+		Relay__delay(500);
+		Relay__set(RelayK2);
+		Relay__delay(500);
+		Relay__resetAll();
 	}
 
 	// Frequenz auf 1kHz setzen
 	SigGen__setFrequency(1000);
 
+	// Ansprechzeit des T400 Relais messen (SW3 beim Einschalten gedrückt)
+	if ((PIND & _BV(SW3)) == 0) {
+		checkRelayResponse();
+	}
+
 	checkWatchdog();
 	Watchdog__init();
 }
@@ -11,14 +11,84 @@
 #include <IntADC/IntADC.h>				// IntADC_*
 #include <ExtADC/ExtADC.h>				// ExtADC_*
 #include <FreqCounter/FreqCounter.h>	// FreqCounter_*
+#include <Timer/Timer.h>				// Timer_*
+#include <SigGen/SigGen.h>				// SigGen_*
+#include <InputCapture/InputCapture.h>	// InputCapture_*
 
 // Statische Definitionen --------------------------------
-static void __startIntADC(void *ctx) {
-	IntADC__startMeasurement(*(u8 *)ctx);
+// Messmodus des Frequenzzählers im Betrieb
+#define __FREQCOUNTER_MODE	FreqCounterAuto
+
+/*!
+ *	Frequenzen für die Kalibrierung des Frequenzzählers.
+ *	Sie werden vom SigGen exakt erzeugt, die
+ *	Periodendauer ist deshalb genau bekannt.
+ */
+static const u16 __nCalFrequencies[3] PROGMEM	= {100, 1000, 4000};
+#define __CAL_CAPTURES		8u
+#define __CAL_TIMEOUT		50u		// ms pro Messung
+
+/*!
+ *	Maximale Ansprechzeit des T400 Relais und Dauer nach
+ *	der ersten Flanke, während der noch Prellen erwartet wird.
+ */
+#define __RELAY_TIMEOUT		2000u	// ms
+#define __RELAY_BOUNCE		50u		// ms
+
+/*!
+ *	Misst eine einzelne Periode ohne Korrektur.
+ *	Gibt 'FALSE' zurück falls keine Flanken kommen
+ *	(keine Verbindung zwischen SigGen und INT2).
+ */
+static bool __captureRaw(u32 *nTicks) {
+	Measure__readings_t readings;
+	u16 nStart = Timer__getTicks();
+
+	FreqCounter__startMeasurement();
+
+	while (FreqCounter__isDone(&readings) == FALSE) {
+		if ((u16)(Timer__getTicks() - nStart) > __CAL_TIMEOUT) {
+			FreqCounter__abort();
+
+			return FALSE;
+		}
+	}
+
+	if (readings.nSum <= 0) {
+		return FALSE;
+	}
+
+	*nTicks = readings.nSum;
+
+	return TRUE;
+}
+
+static void __startIntADCScan(void *ctx) {
+	IntADC__startScan((const u8 *)ctx, 2);
 }
 
 static void __startExtADC(void *ctx) {
-	ExtADC__startMeasurement(ExtADCGain1, *(u8 *)ctx, ExtADC14Bit);
+	ExtADC__startMeasurement(ExtADCGainAuto, *(u8 *)ctx, ExtADC14Bit);
+}
+
+/*!
+ *	Kleinster Gain der Messergebnisse des externen ADC seit
+ *	dem letzten Abholen des Messwertes, bzw. beim Abholen.
+ *	Er bestimmt die Auflösung des gemittelten Messwertes.
+ */
+static ExtADC_gain_t __nExtADCGain		= ExtADCGain8;
+static ExtADC_gain_t __nExtADCLastGain	= ExtADCGain8;
+
+static bool __isDoneExtADC(Measure__readings_t *readings) {
+	if (ExtADC__isDone(readings) == FALSE) {
+		return FALSE;
+	}
+
+	if (readings != NULL && readings->nNum > 0 && ExtADC__getGain() < __nExtADCGain) {
+		__nExtADCGain = ExtADC__getGain();
+	}
+
+	return TRUE;
 }
 
 static void __startFreqCtr(void *ctx) {
@@ -32,9 +102,16 @@ static void __startFreqCtr(void *ctx) {
  *	__addMeasurement Methode nur einen
  *	Pointer akzeptiert.
  */
-static u8	__nT400CurrentCH	= IntADCCH7,	// Interner ADC Kanal 7
-			__nT400VSensorCH	= IntADCCH6,	// Interner ADC Kanal 6
-			__nT400AnalogCH		= ExtADCCH2;	// Externer ADC Kanal 2
+static u8	__nT400AnalogCH		= ExtADCCH2;	// Externer ADC Kanal 2
+
+/*!
+ *	Kanalliste für die Abtastung mit dem internen ADC.
+ *	Reihenfolge entspricht den Kanälen der Messaufgabe.
+ */
+static u8	__nIntADCScanCH[2]	= {
+				IntADCCH7,	// Interner ADC Kanal 7 (Stromaufnahme)
+				IntADCCH6	// Interner ADC Kanal 6 (Sensorversorgungsspannung)
+			};
 
 UNUSED static ldbl __convertT400I(ldbl dResult) {
 	// Messung der Spannung über 40.2 Ohm Widerstand R26/R25
@@ -48,7 +125,8 @@ UNUSED static ldbl __convertT400U(ldbl dResult) {
 
 static ldbl __convertCurrent(ldbl dResult) {
 	// Umwandelung des Spannungwertes ausgegeben vom INA139
-	return dResult * 1E3;
+	// in Ampere, die Anzeige wählt den SI-Präfix selbst (mA)
+	return dResult;
 }
 
 static ldbl __convertVSensor(ldbl dResult) {
@@ -58,46 +136,41 @@ static ldbl __convertVSensor(ldbl dResult) {
 
 static void __addMeasurements(void) {
 	/*!
-	 *	Stromaufnahme des T400 wird über den
-	 *	internen ADC gemessen. (Kanal = ADC7)
+	 *	Stromaufnahme des T400 (Kanal = ADC7) und
+	 *	Sensorversorgungsspannung des T400 (Kanal = ADC6)
+	 *	werden abwechselnd über den internen ADC gemessen.
 	 *
-	 *	Zeitperiode: 150ms
+	 *	Zeitperiode: 50ms
 	 *
-	 *	Messung muss zwingend fertig sein, da interner ADC
-	 *	nur einen Kanal auf einmal messen kann.
+	 *	Messung muss zwingend fertig sein, damit in jeder
+	 *	Zeitperiode beide Kanäle gemessen wurden.
 	 */
 	nMEASURE_T400_CURRENT		= Measure__addMeasurement(
-									__startIntADC,
-									&__nT400CurrentCH,
+									__startIntADCScan,
+									__nIntADCScanCH,
 									IntADC__isDone,
+									IntADC__toVoltage,
 									TRUE,
 									__convertCurrent,
-									150
+									50,
+									MeasureResIntADC
 								);
 
-	/*!
-	 *	Sensorversorgungsspannung des T400 wird über den
-	 *	internen ADC gemessen. (Kanal = ADC6)
-	 *
-	 *	Zeitperiode: 150ms
-	 *
-	 *	Messung muss zwingend fertig sein, da interner ADC
-	 *	nur einen Kanal auf einmal messen kann.
-	 */
-	nMEASURE_T400_VSENSOR		= Measure__addMeasurement(
-									__startIntADC,
-									&__nT400VSensorCH,
-									IntADC__isDone,
-									TRUE,
-									__convertVSensor,
-									150
+	nMEASURE_T400_VSENSOR		= Measure__addChannel(
+									nMEASURE_T400_CURRENT,
+									IntADC__toVoltage,
+									__convertVSensor
 								);
 
 	/*!
 	 *	Openkollektorfrequenz des T400 wird über den
 	 *	externen Interrupt (INT2) gemessen.
 	 *
-	 *	Zeitperiode: 150ms
+	 *	Zeitperiode: 500ms
+	 *
+	 *	Pro Messung werden mehrere Perioden gemittelt,
+	 *	oberhalb von 2kHz werden die ganzen Perioden
+	 *	während einer Torzeit von 100ms gemessen.
 	 *
 	 *	Da Frequenzmessung Frequenzen kleiner 10Hz messen kann
 	 *	muss die Messung nicht zwingend beendet worden sein.
@@ -106,9 +179,11 @@ static void __addMeasurements(void) {
 									__startFreqCtr,
 									NULL,
 									FreqCounter__isDone,
+									FreqCounter__toFrequency,
 									FALSE,
 									NULL,
-									150
+									500,
+									MeasureResFreqCounter
 								);
 
 	/*!
@@ -116,6 +191,8 @@ static void __addMeasurements(void) {
 	 *	externen ADC gemessen.
 	 *
 	 *	Zeitperiode: 150ms
+	 *	Bei 14 Bit Auflösung (20ms) werden im Dauerwandlungsmodus
+	 *	pro Zeitperiode bis zu sieben Messwerte gemittelt.
 	 *
 	 *	Messung muss zwingend fertig sein, da der externe ADC
 	 *	nur einen Kanal auf einmal messen kann.
@@ -125,12 +202,22 @@ static void __addMeasurements(void) {
 	nMEASURE_T400_ANALOGOUTPUT	= Measure__addMeasurement(
 									__startExtADC,
 									&__nT400AnalogCH,
-									ExtADC__isDone,
+									__isDoneExtADC,
+									ExtADC__toVoltage,
 									TRUE,
 									__convertT400U,
-									150
+									150,
+									MeasureResExtADC
 								);
 
+	/*!
+	 *	Die Ausgänge des T400 werden gegen Grenzwerte geprüft,
+	 *	dafür werden Extremwerte und Streuung mitgeführt.
+	 */
+	Measure__enableStatistics(nMEASURE_T400_CURRENT);
+	Measure__enableStatistics(nMEASURE_T400_OCFREQUENCY);
+	Measure__enableStatistics(nMEASURE_T400_ANALOGOUTPUT);
+
 	/*!
 	 *	Noch nicht implementiert.
 	 */
@@ -145,7 +232,8 @@ static void __addMeasurements(void) {
 }
 // Statische Definitionen --------------------------------
 
-const char *measurmentsStrings[5] = {NULL, NULL, NULL, NULL, NULL};
+const char *measurmentsStrings[MEASUREMENTS_COUNT] = {NULL, NULL, NULL, NULL};
+const char *measurmentsUnits[MEASUREMENTS_COUNT] = {NULL, NULL, NULL, NULL};
 
 /*!
  *	@function	initMeasurements
@@ -154,7 +242,9 @@ void initMeasurements(void) {
 	INTERRUPTS_REQUIRED();
 
 	// Module aktivieren
+	Timer__enable();
 	FreqCounter__enable();
+	FreqCounter__setMode(__FREQCOUNTER_MODE);
 	IntADC__enable();
 	ExtADC__enable();
 
@@ -162,15 +252,175 @@ void initMeasurements(void) {
 	__addMeasurements();
 
 	// Bezeichnungen setzen
-	measurmentsStrings[MEASURE_T400_CURRENT]		= "Stra";
-	measurmentsStrings[MEASURE_T400_VSENSOR]		= "Sens";
-	measurmentsStrings[MEASURE_T400_OCFREQUENCY]	= "Freq";
-	measurmentsStrings[MEASURE_T400_ANALOGOUTPUT]	= "Alog";
+	measurmentsStrings[MEASURE_T400_CURRENT]		= PSTR("Stra");
+	measurmentsStrings[MEASURE_T400_VSENSOR]		= PSTR("Sens");
+	measurmentsStrings[MEASURE_T400_OCFREQUENCY]	= PSTR("Freq");
+	measurmentsStrings[MEASURE_T400_ANALOGOUTPUT]	= PSTR("Alog");
+
+	// Einheiten setzen (ohne SI-Präfix)
+	measurmentsUnits[MEASURE_T400_CURRENT]			= "A";
+	measurmentsUnits[MEASURE_T400_VSENSOR]			= "V";
+	measurmentsUnits[MEASURE_T400_OCFREQUENCY]		= "Hz";
+	measurmentsUnits[MEASURE_T400_ANALOGOUTPUT]		= "V";
+}
+
+/*!
+ *	@function	calibrateFreqCounter
+ */
+bool calibrateFreqCounter(bool bStore) {
+	ldbl dSumX	= 0.0L;
+	ldbl dSumY	= 0.0L;
+	ldbl dSumXX	= 0.0L;
+	ldbl dSumXY	= 0.0L;
+	u8 nPoints	= 0;
+	bool bValid	= TRUE;
+
+	INTERRUPTS_REQUIRED();
+
+	FreqCounter__setMode(FreqCounterSinglePeriod);
+	FreqCounter__setCorrection(0, 0);
+
+	/*!
+	 *	Gemessene gegen tatsächliche Periodendauer:
+	 *	gemessen = a * tatsächlich + b
+	 *	b entspricht der Latenz der ISR, a dem Skalierungsfehler.
+	 */
+	for (u8 nI = 0; nI < 3 && bValid; ++nI) {
+		u16 nFrequency	= pgm_read_word(&__nCalFrequencies[nI]);
+		ldbl dTicks		= 16.0E6L / nFrequency;
+
+		SigGen__setFrequency(nFrequency);
+
+		// Erste Messung wird verworfen (Frequenzwechsel)
+		for (u8 nJ = 0; nJ <= __CAL_CAPTURES && bValid; ++nJ) {
+			u32 nTicks;
+
+			bValid = __captureRaw(&nTicks);
+
+			if (bValid && nJ > 0) {
+				dSumX	+= dTicks;
+				dSumY	+= nTicks;
+				dSumXX	+= dTicks * dTicks;
+				dSumXY	+= dTicks * nTicks;
+
+				++nPoints;
+			}
+		}
+	}
+
+	SigGen__setFrequency(0);
+	FreqCounter__setMode(__FREQCOUNTER_MODE);
+
+	if (bValid) {
+		ldbl dSlope		= (nPoints * dSumXY - dSumX * dSumY) / (nPoints * dSumXX - dSumX * dSumX);
+		ldbl dOffset	= (dSumY - dSlope * dSumX) / nPoints;
+		i32 nOffset		= (i32)(dOffset + (dOffset < 0 ? -0.5L : 0.5L));
+		i32 nScalePPM	= (i32)((dSlope - 1.0L) * 1E6L);
+
+		// Unplausible Werte verwerfen
+		bValid = (nOffset > -1000 && nOffset < 1000 && nScalePPM > -10000 && nScalePPM < 10000);
+
+		if (bValid) {
+			FreqCounter__setCorrection(nOffset, nScalePPM);
+
+			// Nur eine bestätigte Rückführung überschreibt das EEPROM
+			if (bStore) {
+				FreqCounter__storeCorrection();
+			}
+		}
+	}
+
+	// Ohne Verbindung gilt die gespeicherte Korrektur
+	if (bValid == FALSE) {
+		FreqCounter__setCorrection(0, 0);
+		FreqCounter__loadCorrection();
+	}
+
+	return bValid;
+}
+
+/*!
+ *	@function	measureRelayResponse
+ */
+bool measureRelayResponse(u32 *nResponse, u32 *nBounce) {
+	InputCapture__event_t start, first, last, event;
+	u32 nFrequency	= SigGen__getFrequency();
+	bool bSwitched	= FALSE;
+	u16 nTimeout	= __RELAY_TIMEOUT;
+	u16 nStart;
+
+	INTERRUPTS_REQUIRED();
+	ASSERT(nResponse != NULL && nBounce != NULL);
+
+	/*!
+	 *	Signalausfall: Der SigGen gibt den Timer/Counter1
+	 *	frei, die Input Capture Einheit zählt ab hier.
+	 */
+	SigGen__disable();
+	InputCapture__start();
+	InputCapture__getStart(&start);
+
+	nStart = Timer__getTicks();
+
+	// Nach der ersten Flanke nur noch das Prellen abwarten
+	while ((u16)(Timer__getTicks() - nStart) < nTimeout) {
+		if (InputCapture__read(&event) == FALSE) {
+			continue;
+		}
+
+		if (bSwitched == FALSE) {
+			first		= event;
+			bSwitched	= TRUE;
+			nStart		= Timer__getTicks();
+			nTimeout	= __RELAY_BOUNCE;
+		}
+
+		last = event;
+	}
+
+	InputCapture__stop();
+
+	// Vorherige Frequenz wieder ausgeben
+	if (nFrequency > 0) {
+		SigGen__setFrequencyMilli(nFrequency);
+	}
+
+	if (bSwitched == FALSE) {
+		return FALSE;
+	}
+
+	*nResponse	= InputCapture__getInterval(&start, &first);
+	*nBounce	= InputCapture__getInterval(&first, &last);
+
+	/*!
+	 *	Bei vollem Ringpuffer werden die neuesten Flanken
+	 *	verworfen. Die erste Flanke ist immer gespeichert,
+	 *	die letzte gelesene ist dann aber nicht die letzte.
+	 */
+	if (InputCapture__getLost() > 0) {
+		*nBounce	= RELAY_BOUNCE_LOST;
+	}
+
+	return TRUE;
 }
 
 /*!
  *	@function	getMeasurement
  */
 bool getMeasurement(Measure__MeasurementID_t nID, ldbl *dResult) {
-	return Measure__getMeasuredValue(nID, dResult);
+	bool bNew = Measure__getMeasuredValue(nID, dResult);
+
+	if (bNew && nID == MEASURE_T400_ANALOGOUTPUT) {
+		__nExtADCLastGain	= __nExtADCGain;
+		__nExtADCGain		= ExtADCGain8;
+	}
+
+	return bNew;
+}
+
+/*!
+ *	@function	getAnalogOutputGain
+ */
+ExtADC_gain_t getAnalogOutputGain(void) {
+	return __nExtADCLastGain;
 }
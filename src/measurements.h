@@ -10,6 +10,7 @@
 
 	#include <common/common.h>
 	#include <Measure/Measure.h>
+	#include <ExtADC/ExtADC.h>
 
 	#if !defined(MEASUREMENTS_H_EXTERN)
 		#define MEASUREMENTS_H_EXTERN extern
@@ -27,9 +28,76 @@
 	#define MEASURE_T400_ANALOGOUTPUT	nMEASURE_T400_ANALOGOUTPUT
 	#define MEASURE_TEMPERATURE			nMEASURE_TEMPERATURE
 
-	extern const char *measurmentsStrings[5];
+	// Drei Messaufgaben und ein Kanal (Temperatur noch nicht implementiert)
+	#define MEASUREMENTS_COUNT			4u
+
+	// Bezeichnungen liegen im Flash (PSTR)
+	extern const char *measurmentsStrings[MEASUREMENTS_COUNT];
+	extern const char *measurmentsUnits[MEASUREMENTS_COUNT];
 
 	void initMeasurements(void);
+
+	/*!
+	 *	@function	calibrateFreqCounter
+	 *	@brief
+	 *	Kalibriert den Frequenzzähler mit dem SigGen.
+	 *	Dazu muss PD5 (T400_SIG) mit INT2 verbunden sein
+	 *	(Relais oder Jumper). Es werden einige bekannte Frequenzen
+	 *	gemessen und daraus Offset (Latenz der ISR) und
+	 *	Skalierung bestimmt. Die Korrektur gilt bis zum Ausschalten,
+	 *	im EEPROM wird sie nur mit `bStore` gespeichert.
+	 *	Ohne Verbindung wird die gespeicherte Korrektur geladen.
+	 *
+	 *	@param		bStore		'TRUE' falls die Verbindung bestätigt
+	 *	wurde (z.B. durch den Bediener) und die Korrektur im EEPROM
+	 *	gespeichert werden soll.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls kalibriert wurde, ansonsten 'FALSE'.
+	 *
+	 *	@warning
+	 *		- initMeasurements und SigGen__enable müssen
+	 *		  vorher aufgerufen worden sein!
+	 *		- Blockiert bis zu einer halben Sekunde.
+	 */
+	bool calibrateFreqCounter(bool bStore);
+	/*!
+	 *	@function	measureRelayResponse
+	 *	@brief
+	 *	Misst die Ansprechzeit des T400 Relais bei Signalausfall.
+	 *	Der SigGen wird angehalten, die Flanken des Relaiskontaktes
+	 *	(T400_COM) werden mit der Input Capture Einheit aufgezeichnet.
+	 *	Danach gibt der SigGen wieder die vorherige Frequenz aus.
+	 *
+	 *	@param		nResponse	Zeit bis zur ersten Flanke (62.5ns).
+	 *	@param		nBounce		Zeit von der ersten bis zur letzten Flanke (62.5ns)
+	 *	oder RELAY_BOUNCE_LOST falls Flanken verloren gingen.
+	 *
+	 *	@return		bool
+	 *	'TRUE' falls das Relais geschaltet hat, ansonsten 'FALSE'.
+	 *
+	 *	@warning
+	 *		- SigGen__enable und InputCapture__enable müssen
+	 *		  vorher aufgerufen worden sein!
+	 *		- Blockiert bis zu zwei Sekunden.
+	 */
+	bool measureRelayResponse(u32 *nResponse, u32 *nBounce);
+
+	// Prelldauer unbekannt, Ringpuffer der Input Capture Einheit war voll
+	#define RELAY_BOUNCE_LOST	0xFFFFFFFFul
+
 	bool getMeasurement(Measure__MeasurementID_t nID, ldbl *dResult);
 
+	/*!
+	 *	@function	getAnalogOutputGain
+	 *	@brief
+	 *	Gibt den kleinsten Gain des externen ADC zurück, mit dem
+	 *	der zuletzt abgeholte Wert des analogen Ausgangs
+	 *	(MEASURE_T400_ANALOGOUTPUT) gemessen wurde.
+	 *
+	 *	@return		ExtADC_gain_t
+	 *	Gain (1x, 2x, 4x oder 8x).
+	 */
+	ExtADC_gain_t getAnalogOutputGain(void);
+
 #endif // !defined(JAQ_MEASUREMENTS_H)